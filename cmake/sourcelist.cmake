@@ -1,19 +1,55 @@
 set(SOURCES
+	include/BOSAPI.h
+	include/CellDataCache.h
 	include/ConditionalData.h
+	include/ConflictReport.h
+	include/ConsoleCommands.h
+	include/FilterProfile.h
 	include/Hooks.h
+	include/LazyRules.h
+	include/LeveledList.h
+	include/LoadErrors.h
+	include/LoadProfiler.h
 	include/Manager.h
+	include/MemoryReport.h
 	include/ObjectProperties.h
 	include/PCH.h
 	include/RNG.h
+	include/RefContext.h
+	include/Serialization.h
+	include/Settings.h
+	include/ShadowEval.h
+	include/SpatialIndex.h
 	include/SwapData.h
+	include/SwapExplain.h
+	include/TraceFormat.h
+	include/TraceRecorder.h
 	include/Util.h
+	include/WildcardIndex.h
+	src/API.cpp
+	src/CellDataCache.cpp
 	src/ConditionalData.cpp
+	src/ConflictReport.cpp
+	src/ConsoleCommands.cpp
+	src/FilterProfile.cpp
 	src/Hooks.cpp
+	src/LeveledList.cpp
+	src/LoadErrors.cpp
+	src/LoadProfiler.cpp
 	src/Manager.cpp
+	src/MemoryReport.cpp
 	src/ObjectProperties.cpp
 	src/PCH.cpp
 	src/RNG.cpp
+	src/RefContext.cpp
+	src/Serialization.cpp
+	src/Settings.cpp
+	src/ShadowEval.cpp
+	src/SpatialIndex.cpp
 	src/SwapData.cpp
+	src/SwapExplain.cpp
+	src/TraceRecorder.cpp
 	src/Util.cpp
+	src/WildcardIndex.cpp
 	src/main.cpp
 )
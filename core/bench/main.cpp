@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Core/INIReader.h"
+#include "Core/RuleParser.h"
+
+using namespace std::literals;
+
+// host throughput of the config parsers over a generate_swap_corpus.py folder
+// usage : bos_core_bench <corpus folder> [iterations]
+// formIDs resolve through a stub, plugins get load order indices as they are seen and every editorID resolves,
+// so the numbers cover reading, splitting and formID parsing but not the game's form lookups
+
+namespace
+{
+	class StubFormLookup final : public core::FormLookup
+	{
+	public:
+		std::uint32_t LookupFormID(std::uint32_t a_localID, std::string_view a_plugin) const override
+		{
+			auto it = plugins.find(a_plugin);
+			if (it == plugins.end()) {
+				it = plugins.emplace(std::string(a_plugin), static_cast<std::uint32_t>(plugins.size())).first;
+			}
+			return (it->second << 24) | (a_localID & 0xFFFFFF);
+		}
+
+		std::uint32_t LookupEditorID(std::string_view a_editorID) const override
+		{
+			return static_cast<std::uint32_t>(std::hash<std::string_view>{}(a_editorID)) | 1;
+		}
+
+		bool IsLoaded(std::uint32_t) const override
+		{
+			return true;
+		}
+
+		void Report(core::ParseError, std::string_view) const override
+		{
+			++errors;
+		}
+
+		// members
+		struct string_hash
+		{
+			using is_transparent = void;
+			std::size_t operator()(std::string_view a_str) const { return std::hash<std::string_view>{}(a_str); }
+		};
+
+		mutable std::unordered_map<std::string, std::uint32_t, string_hash, std::equal_to<>> plugins{};
+		mutable std::size_t                                                                  errors{ 0 };
+	};
+
+	struct Totals
+	{
+		std::size_t bytes{ 0 };
+		std::size_t entries{ 0 };
+		std::size_t rules{ 0 };
+		std::size_t conditions{ 0 };
+	};
+
+	void parse_file(const std::string& a_path, const StubFormLookup& a_lookup, Totals& a_totals)
+	{
+		ini::Reader reader;
+		if (!reader.Open(a_path)) {
+			std::fprintf(stderr, "unable to open %s\n", a_path.c_str());
+			return;
+		}
+		a_totals.bytes += reader.size();
+
+		for (const auto& [name, keys] : reader.ReadSections()) {
+			const auto split = name.find('|');
+			const auto type = name.substr(0, split);
+
+			// condition atoms, spatial filters aside
+			if (split != std::string_view::npos) {
+				auto conditions = name.substr(split + 1);
+				while (!conditions.empty()) {
+					auto condition = conditions.substr(0, conditions.find(','));
+					conditions.remove_prefix(std::min(condition.size() + 1, conditions.size()));
+					if (condition.starts_with('-')) {
+						condition.remove_prefix(1);
+					}
+					a_totals.conditions += core::ResolveFormID(a_lookup, condition) != 0;
+				}
+			}
+
+			const bool properties = type == "Properties"sv || type == "Transforms"sv;
+			for (const auto& key : keys) {
+				const auto line = properties ? core::ParsePropertiesLine(a_lookup, key) : core::ParseSwapLine(a_lookup, key);
+				a_totals.rules += line.has_value();
+			}
+			a_totals.entries += keys.size();
+		}
+	}
+}
+
+int main(int a_argc, char* a_argv[])
+{
+	if (a_argc < 2) {
+		std::fprintf(stderr, "usage : %s <corpus folder> [iterations]\n", a_argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	const auto iterations = a_argc > 2 ? std::max(1, std::atoi(a_argv[2])) : 10;
+
+	std::vector<std::string> paths;
+	std::error_code          ec;
+	for (const auto& entry : std::filesystem::directory_iterator(a_argv[1], ec)) {
+		if (entry.path().filename().string().ends_with("_SWAP.ini")) {
+			paths.push_back(entry.path().string());
+		}
+	}
+	if (paths.empty()) {
+		std::fprintf(stderr, "no _SWAP.ini files in %s\n", a_argv[1]);
+		return EXIT_FAILURE;
+	}
+
+	StubFormLookup lookup;
+	Totals         totals;
+	double         best = 0.0;
+
+	for (int i = 0; i < iterations; ++i) {
+		totals = {};
+		lookup.errors = 0;
+
+		const auto start = std::chrono::steady_clock::now();
+		for (const auto& path : paths) {
+			parse_file(path, lookup, totals);
+		}
+		const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		best = i == 0 ? seconds : std::min(best, seconds);
+	}
+
+	std::printf("%zu files, %zu entries (%zu rules, %zu errors), %zu condition atoms, %.2f MB\n",
+		paths.size(), totals.entries, totals.rules, lookup.errors, totals.conditions, totals.bytes / (1024.0 * 1024.0));
+	std::printf("best of %d : %.2f ms, %.1f MB/s, %.0f entries/s\n",
+		iterations, best * 1000.0, totals.bytes / (1024.0 * 1024.0) / best, totals.entries / best);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "Core/ResultBits.h"
+
+namespace core
+{
+	// NOT/MATCH filter lists of many entries, with identical atoms interned
+	// an entry passes if none of its NOT atoms and any of its MATCH atoms (or no MATCH atoms) are valid
+	template <class Atom>
+	class CompiledFilterList
+	{
+	public:
+		void clear()
+		{
+			atoms.clear();
+			atomIndices.clear();
+			entries.clear();
+		}
+
+		void reserve(std::size_t a_entries) { entries.reserve(a_entries); }
+
+		void Add(std::span<const Atom> a_not, std::span<const Atom> a_match)
+		{
+			Entry entry;
+			entry.notBegin = static_cast<std::uint32_t>(atomIndices.size());
+			add_atoms(a_not);
+			entry.matchBegin = static_cast<std::uint32_t>(atomIndices.size());
+			add_atoms(a_match);
+			entry.matchEnd = static_cast<std::uint32_t>(atomIndices.size());
+			entries.push_back(entry);
+		}
+
+		void shrink_to_fit()
+		{
+			atoms.shrink_to_fit();
+			atomIndices.shrink_to_fit();
+			entries.shrink_to_fit();
+		}
+
+		// last passing entry, each distinct atom is evaluated at most once
+		// a_isAtomValid(atom index, const Atom&) -> bool
+		// a_isEntryValid(index, evaluate) -> bool, lets callers cache whole entries, return evaluate() otherwise
+		template <class AtomFn, class EntryFn>
+		std::optional<std::size_t> FindLast(AtomFn&& a_isAtomValid, EntryFn&& a_isEntryValid) const
+		{
+			ResultBits<256> results;
+			for (auto i = entries.size(); i-- > 0;) {
+				if (is_entry_valid(i, results, a_isAtomValid, a_isEntryValid)) {
+					return i;
+				}
+			}
+
+			return std::nullopt;
+		}
+
+		// as above, only testing a_candidates, entry indices in ascending order
+		template <class AtomFn, class EntryFn>
+		std::optional<std::size_t> FindLast(std::span<const std::uint32_t> a_candidates, AtomFn&& a_isAtomValid, EntryFn&& a_isEntryValid) const
+		{
+			ResultBits<256> results;
+			for (auto it = a_candidates.rbegin(); it != a_candidates.rend(); ++it) {
+				if (is_entry_valid(*it, results, a_isAtomValid, a_isEntryValid)) {
+					return *it;
+				}
+			}
+
+			return std::nullopt;
+		}
+
+		[[nodiscard]] std::span<const Atom> GetAtoms() const { return atoms; }
+
+		[[nodiscard]] std::size_t size() const { return entries.size(); }
+		[[nodiscard]] std::size_t GetAtomCount() const { return atoms.size(); }
+		[[nodiscard]] std::size_t GetFilterCount() const { return atomIndices.size(); }
+
+		// excluding heap memory owned by the atoms
+		[[nodiscard]] std::size_t GetHeapBytes() const
+		{
+			return atoms.capacity() * sizeof(Atom) + atomIndices.capacity() * sizeof(std::uint32_t) + entries.capacity() * sizeof(Entry);
+		}
+
+	private:
+		struct Entry
+		{
+			std::uint32_t notBegin{ 0 };
+			std::uint32_t matchBegin{ 0 };
+			std::uint32_t matchEnd{ 0 };
+		};
+
+		template <class AtomFn, class EntryFn>
+		bool is_entry_valid(std::size_t a_index, ResultBits<256>& a_results, AtomFn& a_isAtomValid, EntryFn& a_isEntryValid) const
+		{
+			const auto is_valid = [&](std::uint32_t a_atom) {
+				return a_results.Get(a_atom, [&] { return a_isAtomValid(a_atom, atoms[a_atom]); });
+			};
+			const auto evaluate = [&] {
+				const auto& [notBegin, matchBegin, matchEnd] = entries[a_index];
+
+				const auto notAtoms = std::span(atomIndices).subspan(notBegin, matchBegin - notBegin);
+				if (std::ranges::any_of(notAtoms, is_valid)) {
+					return false;
+				}
+
+				const auto matchAtoms = std::span(atomIndices).subspan(matchBegin, matchEnd - matchBegin);
+				return matchAtoms.empty() || std::ranges::any_of(matchAtoms, is_valid);
+			};
+			return a_isEntryValid(a_index, evaluate);
+		}
+
+		void add_atoms(std::span<const Atom> a_atoms)
+		{
+			for (const auto& atom : a_atoms) {
+				auto it = std::ranges::find(atoms, atom);
+				if (it == atoms.end()) {
+					it = atoms.insert(atoms.end(), atom);
+				}
+				atomIndices.push_back(static_cast<std::uint32_t>(std::distance(atoms.begin(), it)));
+			}
+		}
+
+		// members
+		std::vector<Atom>          atoms{};
+		std::vector<std::uint32_t> atomIndices{};
+		std::vector<Entry>         entries{};
+	};
+}
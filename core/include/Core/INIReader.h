@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <mmio/mmio.hpp>
+
+namespace ini
+{
+	// forward-only reader over a memory mapped INI
+	// emits sections and keys in file order, as views into the mapping
+	// ReadSections groups them the way CSimpleIniA with SetMultiKey did, which rule order depends on
+	class Reader
+	{
+	public:
+		enum class EVENT
+		{
+			kSection,
+			kKey
+		};
+
+		struct Event
+		{
+			EVENT            type{ EVENT::kKey };
+			std::string_view text{};
+		};
+
+		struct Section
+		{
+			std::string_view              name{};
+			std::vector<std::string_view> keys{};
+		};
+
+		Reader() = default;
+
+		bool                      Open(const std::string& a_path);
+		[[nodiscard]] std::size_t size() const;
+
+		bool Next(Event& a_event);
+
+		// repeated headers are merged into the first section of the same name (case-insensitive),
+		// sections in order of first appearance, keys in file order, keys before the first header are dropped
+		std::vector<Section> ReadSections();
+
+	private:
+		// members
+		mmio::mapped_file_source file{};
+		std::string_view         remaining{};
+	};
+}
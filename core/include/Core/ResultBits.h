@@ -0,0 +1,40 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace core
+{
+	// evaluated/result bits for the first N ids, kept inline
+	// ids past that are evaluated directly
+	template <std::uint32_t N>
+	class ResultBits
+	{
+	public:
+		template <class F>
+		bool Get(std::uint32_t a_id, F&& a_evaluate)
+		{
+			if (a_id >= N) {
+				return a_evaluate();
+			}
+			const auto word = a_id / 64;
+			const auto bit = std::uint64_t(1) << (a_id % 64);
+			if ((evaluated[word] & bit) == 0) {
+				evaluated[word] |= bit;
+				if (a_evaluate()) {
+					results[word] |= bit;
+				}
+			}
+			return (results[word] & bit) != 0;
+		}
+
+		static constexpr std::uint32_t maxIDs{ N };
+
+	private:
+		static_assert(N % 64 == 0);
+
+		// members
+		std::array<std::uint64_t, N / 64> evaluated{};
+		std::array<std::uint64_t, N / 64> results{};
+	};
+}
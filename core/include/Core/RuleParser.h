@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace core
+{
+	enum class ParseError : std::uint32_t
+	{
+		kBaseNotFound,
+		kSwapNotFound,
+		kSwapSetNotFound,
+		kBaseSameAsSwap,
+		kFilterFormIDNotFound
+	};
+
+	// form lookups needed by the rule parsers
+	// backed by the loaded data in the plugin, by a stub on the host
+	class FormLookup
+	{
+	public:
+		virtual ~FormLookup() = default;
+
+		// 0x123~Plugin.esp, 0 if the plugin or form isn't loaded
+		virtual std::uint32_t LookupFormID(std::uint32_t a_localID, std::string_view a_plugin) const = 0;
+		// 0 if no form has this editorID
+		virtual std::uint32_t LookupEditorID(std::string_view a_editorID) const = 0;
+		virtual bool          IsLoaded(std::uint32_t a_formID) const = 0;
+
+		virtual void Report([[maybe_unused]] ParseError a_error, [[maybe_unused]] std::string_view a_entry) const {}
+	};
+
+	// BASE|SWAP|PROPERTIES|CHANCE or BASE|PROPERTIES|CHANCE
+	// views point into the parsed line
+	struct RuleLine
+	{
+		std::uint32_t              baseID{ 0 };
+		std::vector<std::uint32_t> swapIDs{};
+		bool                       swapSet{ false };  // comma separated, a set even if one form is left
+		std::string_view           properties{};
+		std::string_view           chance{};
+	};
+
+	// not empty and not NONE
+	bool IsValidEntry(std::string_view a_str);
+
+	// "0x123~Plugin.esp", "0x01000123" or "EditorID"
+	// hex formIDs are returned even if no form has them (cell formIDs aren't always loaded)
+	std::uint32_t ResolveFormID(const FormLookup& a_lookup, std::string_view a_str);
+
+	std::optional<RuleLine> ParseSwapLine(const FormLookup& a_lookup, std::string_view a_str);
+	// SWAP, PROPERTIES and CHANCE only, for keys that aren't forms, baseID is left at 0
+	std::optional<RuleLine> ParseSwapFields(const FormLookup& a_lookup, std::string_view a_str);
+	std::optional<RuleLine> ParsePropertiesLine(const FormLookup& a_lookup, std::string_view a_str);
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+
+namespace core
+{
+	// container split into shards by key, each behind its own reader/writer lock
+	// readers on different shards never touch the same lock cache line
+	template <class Container, std::size_t Shards = 16>
+	class ShardedTable
+	{
+	public:
+		using key_type = typename Container::key_type;
+
+		// a_func(const Container&) with the key's shard locked shared
+		template <class F>
+		decltype(auto) read(const key_type& a_key, F&& a_func) const
+		{
+			const auto&      shard = get_shard(a_key);
+			std::shared_lock lock(shard.lock);
+			return a_func(shard.container);
+		}
+
+		// a_func(Container&) with the key's shard locked exclusive
+		template <class F>
+		decltype(auto) write(const key_type& a_key, F&& a_func)
+		{
+			auto&            shard = get_shard(a_key);
+			std::unique_lock lock(shard.lock);
+			return a_func(shard.container);
+		}
+
+		// a_func(const Container&) for each shard in turn
+		template <class F>
+		void for_each_shard(F&& a_func) const
+		{
+			for (const auto& shard : shards) {
+				std::shared_lock lock(shard.lock);
+				a_func(shard.container);
+			}
+		}
+
+		void clear()
+		{
+			for (auto& shard : shards) {
+				std::unique_lock lock(shard.lock);
+				shard.container.clear();
+			}
+		}
+
+		[[nodiscard]] std::size_t size() const
+		{
+			std::size_t result = 0;
+			for_each_shard([&](const Container& a_container) { result += a_container.size(); });
+			return result;
+		}
+
+		static constexpr std::size_t shardCount{ Shards };
+
+	private:
+		struct alignas(64) Shard
+		{
+			mutable std::shared_mutex lock{};
+			Container                 container{};
+		};
+
+		static std::size_t get_shard_index(const key_type& a_key)
+		{
+			if constexpr (Shards == 1) {
+				return 0;
+			} else {
+				// formIDs share their high byte per plugin, mix before taking the shard
+				const auto hash = static_cast<std::uint64_t>(a_key) * 0x9E3779B97F4A7C15ull;
+				return static_cast<std::size_t>(hash >> 32) % Shards;
+			}
+		}
+
+		const Shard& get_shard(const key_type& a_key) const { return shards[get_shard_index(a_key)]; }
+		Shard&       get_shard(const key_type& a_key) { return shards[get_shard_index(a_key)]; }
+
+		// members
+		std::array<Shard, Shards> shards{};
+	};
+}
@@ -0,0 +1,96 @@
+#include "Core/INIReader.h"
+
+#include <algorithm>
+
+using namespace std::literals;
+
+namespace ini
+{
+	namespace
+	{
+		std::string_view trim(std::string_view a_str)
+		{
+			const auto first = a_str.find_first_not_of(" \t\r");
+			if (first == std::string_view::npos) {
+				return {};
+			}
+			return a_str.substr(first, a_str.find_last_not_of(" \t\r") - first + 1);
+		}
+
+		bool iequals(std::string_view a_lhs, std::string_view a_rhs)
+		{
+			constexpr auto to_lower = [](char a_ch) {
+				return a_ch >= 'A' && a_ch <= 'Z' ? static_cast<char>(a_ch - 'A' + 'a') : a_ch;
+			};
+			return a_lhs.size() == a_rhs.size() && std::equal(a_lhs.begin(), a_lhs.end(), a_rhs.begin(), [&](char a_l, char a_r) {
+				return to_lower(a_l) == to_lower(a_r);
+			});
+		}
+	}
+
+	bool Reader::Open(const std::string& a_path)
+	{
+		if (!file.open(a_path) || !file.is_open()) {
+			return false;
+		}
+
+		remaining = { reinterpret_cast<const char*>(file.data()), file.size() };
+		if (remaining.starts_with("\xEF\xBB\xBF"sv)) {  // UTF-8 BOM
+			remaining.remove_prefix(3);
+		}
+
+		return true;
+	}
+
+	std::size_t Reader::size() const
+	{
+		return file.size();
+	}
+
+	bool Reader::Next(Event& a_event)
+	{
+		while (!remaining.empty()) {
+			const auto lineEnd = remaining.find('\n');
+			auto       line = trim(remaining.substr(0, lineEnd));
+			remaining.remove_prefix(lineEnd == std::string_view::npos ? remaining.size() : lineEnd + 1);
+
+			if (line.empty() || line.front() == ';' || line.front() == '#') {
+				continue;
+			}
+
+			if (line.front() == '[') {
+				if (const auto sectionEnd = line.find(']'); sectionEnd != std::string_view::npos) {
+					a_event = { EVENT::kSection, trim(line.substr(1, sectionEnd - 1)) };
+					return true;
+				}
+				continue;
+			}
+
+			// key only entries, anything after '=' is a value we don't use
+			if (const auto key = trim(line.substr(0, line.find('='))); !key.empty()) {
+				a_event = { EVENT::kKey, key };
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	std::vector<Reader::Section> Reader::ReadSections()
+	{
+		std::vector<Section> sections;
+		Section*             current = nullptr;
+
+		Event event;
+		while (Next(event)) {
+			if (event.type == EVENT::kSection) {
+				const auto it = std::ranges::find_if(sections, [&](const Section& a_section) { return iequals(a_section.name, event.text); });
+				current = it != sections.end() ? std::addressof(*it) : std::addressof(sections.emplace_back(event.text));
+			} else if (current) {
+				current->keys.push_back(event.text);
+			}
+		}
+
+		return sections;
+	}
+}
@@ -0,0 +1,151 @@
+#include "Core/RuleParser.h"
+
+#include <algorithm>
+#include <charconv>
+
+using namespace std::literals;
+
+namespace core
+{
+	namespace
+	{
+		char to_lower(char a_ch)
+		{
+			return a_ch >= 'A' && a_ch <= 'Z' ? static_cast<char>(a_ch - 'A' + 'a') : a_ch;
+		}
+
+		bool is_hex(char a_ch)
+		{
+			return (a_ch >= '0' && a_ch <= '9') || (to_lower(a_ch) >= 'a' && to_lower(a_ch) <= 'f');
+		}
+
+		bool has_hex_prefix(std::string_view a_str)
+		{
+			return a_str.starts_with("0x"sv) || a_str.starts_with("0X"sv);
+		}
+
+		// 0x prefixed, hex digits only
+		bool is_only_hex(std::string_view a_str)
+		{
+			return has_hex_prefix(a_str) && a_str.size() > 2 && std::all_of(a_str.begin() + 2, a_str.end(), is_hex);
+		}
+
+		// leading whitespace and 0x are skipped, parsing stops at the first non hex digit
+		std::uint32_t to_hex(std::string_view a_str)
+		{
+			a_str.remove_prefix(std::min(a_str.find_first_not_of(" \t"), a_str.size()));
+			if (has_hex_prefix(a_str)) {
+				a_str.remove_prefix(2);
+			}
+			std::uint32_t value = 0;
+			std::from_chars(a_str.data(), a_str.data() + a_str.size(), value, 16);
+			return value;
+		}
+
+		std::vector<std::string_view> split(std::string_view a_str, char a_delimiter)
+		{
+			std::vector<std::string_view> result;
+			std::size_t                   begin = 0;
+			for (auto end = a_str.find(a_delimiter); end != std::string_view::npos; end = a_str.find(a_delimiter, begin)) {
+				result.push_back(a_str.substr(begin, end - begin));
+				begin = end + 1;
+			}
+			result.push_back(a_str.substr(begin));
+			return result;
+		}
+	}
+
+	bool IsValidEntry(std::string_view a_str)
+	{
+		constexpr auto none = "none"sv;
+		constexpr auto iequal = [](char a_l, char a_r) { return to_lower(a_l) == a_r; };
+		return !a_str.empty() && std::search(a_str.begin(), a_str.end(), none.begin(), none.end(), iequal) == a_str.end();
+	}
+
+	std::uint32_t ResolveFormID(const FormLookup& a_lookup, std::string_view a_str)
+	{
+		if (const auto splitID = split(a_str, '~'); splitID.size() == 2) {
+			return a_lookup.LookupFormID(to_hex(splitID[0]), splitID[1]);
+		}
+		if (is_only_hex(a_str)) {
+			const auto formID = to_hex(a_str);
+			if (!a_lookup.IsLoaded(formID)) {
+				a_lookup.Report(ParseError::kFilterFormIDNotFound, a_str);
+			}
+			return formID;
+		}
+		return a_lookup.LookupEditorID(a_str);
+	}
+
+	std::optional<RuleLine> ParseSwapFields(const FormLookup& a_lookup, std::string_view a_str)
+	{
+		const auto formPair = split(a_str, '|');
+
+		RuleLine line;
+
+		const auto swapStr = formPair.size() > 1 ? formPair[1] : std::string_view{};
+		if (swapStr.contains(',')) {
+			line.swapSet = true;
+			const auto IDStrs = split(swapStr, ',');
+			line.swapIDs.reserve(IDStrs.size());
+			for (const auto& IDStr : IDStrs) {
+				if (const auto formID = ResolveFormID(a_lookup, IDStr); formID != 0) {
+					line.swapIDs.push_back(formID);
+				} else {
+					a_lookup.Report(ParseError::kSwapSetNotFound, IDStr);
+				}
+			}
+		} else if (const auto formID = ResolveFormID(a_lookup, swapStr); formID != 0) {
+			line.swapIDs.push_back(formID);
+		}
+
+		if (line.swapIDs.empty()) {
+			a_lookup.Report(ParseError::kSwapNotFound, a_str);
+			return std::nullopt;
+		}
+
+		line.properties = formPair.size() > 2 ? formPair[2] : std::string_view{};
+		line.chance = formPair.size() > 3 ? formPair[3] : std::string_view{};
+
+		return line;
+	}
+
+	std::optional<RuleLine> ParseSwapLine(const FormLookup& a_lookup, std::string_view a_str)
+	{
+		const auto baseID = ResolveFormID(a_lookup, a_str.substr(0, a_str.find('|')));
+		if (baseID == 0) {
+			a_lookup.Report(ParseError::kBaseNotFound, a_str);
+			return std::nullopt;
+		}
+
+		auto line = ParseSwapFields(a_lookup, a_str);
+		if (!line) {
+			return std::nullopt;
+		}
+		line->baseID = baseID;
+
+		if (!line->swapSet && line->swapIDs.front() == baseID && !IsValidEntry(line->properties)) {
+			a_lookup.Report(ParseError::kBaseSameAsSwap, a_str);
+			return std::nullopt;
+		}
+
+		return line;
+	}
+
+	std::optional<RuleLine> ParsePropertiesLine(const FormLookup& a_lookup, std::string_view a_str)
+	{
+		const auto formPair = split(a_str, '|');
+
+		RuleLine line;
+		line.baseID = ResolveFormID(a_lookup, formPair[0]);
+		if (line.baseID == 0) {
+			a_lookup.Report(ParseError::kBaseNotFound, a_str);
+			return std::nullopt;
+		}
+
+		line.properties = formPair.size() > 1 ? formPair[1] : std::string_view{};
+		line.chance = formPair.size() > 2 ? formPair[2] : std::string_view{};
+
+		return line;
+	}
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+// failed checks are printed and fail the run, later checks still run
+namespace test
+{
+	inline int failures{ 0 };
+}
+
+#define CHECK(a_expr)                                                                    \
+	do {                                                                                 \
+		if (!(a_expr)) {                                                                 \
+			std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #a_expr); \
+			++test::failures;                                                            \
+		}                                                                                \
+	} while (false)
+
+void TestCompiledFilters();
+void TestResultBits();
+void TestRuleParser();
+void TestShardedTable();
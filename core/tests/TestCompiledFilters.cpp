@@ -0,0 +1,103 @@
+#include "Test.h"
+
+#include <array>
+#include <set>
+#include <vector>
+
+#include "Core/CompiledFilters.h"
+
+void TestCompiledFilters()
+{
+	using List = core::CompiledFilterList<int>;
+
+	const auto find_last = [](const List& a_list, const std::set<int>& a_valid, int* a_atomCalls = nullptr) {
+		return a_list.FindLast(
+			[&](std::uint32_t, int a_atom) {
+				if (a_atomCalls) {
+					++*a_atomCalls;
+				}
+				return a_valid.contains(a_atom);
+			},
+			[](std::size_t, auto&& a_evaluate) { return a_evaluate(); });
+	};
+
+	List list;
+	{
+		constexpr std::array<int, 0> none{};
+		constexpr std::array         notTwo{ 2 };
+		constexpr std::array         oneOrThree{ 1, 3 };
+		constexpr std::array         three{ 3 };
+
+		list.Add(none, none);          // 0 : unconditional
+		list.Add(notTwo, oneOrThree);  // 1 : !2 && (1 || 3)
+		list.Add(none, three);         // 2 : 3
+	}
+
+	CHECK(list.size() == 3);
+	CHECK(list.GetAtomCount() == 3);
+	CHECK(list.GetFilterCount() == 4);
+
+	// last passing entry wins
+	CHECK(find_last(list, { 3 }) == 2);
+	CHECK(find_last(list, { 1 }) == 1);
+	CHECK(find_last(list, { 1, 2 }) == 0);
+	CHECK(find_last(list, {}) == 0);
+
+	// atom 3 is shared by entries 1 and 2, and evaluated once
+	{
+		int atomCalls = 0;
+		CHECK(find_last(list, {}, &atomCalls) == 0);
+		CHECK(atomCalls == 3);
+	}
+
+	// entry callback can skip entries
+	{
+		const auto index = list.FindLast(
+			[](std::uint32_t, int a_atom) { return a_atom == 3; },
+			[](std::size_t a_index, auto&& a_evaluate) { return a_index != 2 && a_evaluate(); });
+		CHECK(index == 1);
+	}
+
+	// NOT only entries match when none of their atoms are valid
+	{
+		List                 notOnly;
+		constexpr std::array notOne{ 1 };
+		notOnly.Add(notOne, std::span<const int>{});
+
+		CHECK(find_last(notOnly, {}) == 0);
+		CHECK(!find_last(notOnly, { 1 }));
+	}
+
+	// atom indices follow first use, so callers can keep per-atom data alongside
+	{
+		std::vector<std::uint32_t> indices;
+		list.FindLast(
+			[&](std::uint32_t a_index, int a_atom) {
+				indices.push_back(a_index);
+				CHECK(list.GetAtoms()[a_index] == a_atom);
+				return false;
+			},
+			[](std::size_t, auto&& a_evaluate) { return a_evaluate(); });
+		CHECK((indices == std::vector<std::uint32_t>{ 2, 0, 1 }));
+	}
+
+	// candidate overload only tests the given entries, last one first
+	{
+		constexpr std::array<std::uint32_t, 2> firstTwo{ 0, 1 };
+		const auto                             index = list.FindLast(
+			firstTwo,
+			[](std::uint32_t, int a_atom) { return a_atom == 3; },
+			[](std::size_t, auto&& a_evaluate) { return a_evaluate(); });
+		CHECK(index == 1);
+
+		constexpr std::array<std::uint32_t, 1> lastOnly{ 2 };
+		CHECK(!list.FindLast(
+			lastOnly,
+			[](std::uint32_t, int) { return false; },
+			[](std::size_t, auto&& a_evaluate) { return a_evaluate(); }));
+	}
+
+	list.clear();
+	CHECK(list.size() == 0);
+	CHECK(!find_last(list, {}));
+}
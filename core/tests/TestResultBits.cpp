@@ -0,0 +1,39 @@
+#include "Test.h"
+
+#include "Core/ResultBits.h"
+
+void TestResultBits()
+{
+	// each inline id is evaluated once, the cached result is returned after that
+	{
+		core::ResultBits<128> bits;
+		int                   calls = 0;
+		const auto            is_odd = [&](std::uint32_t a_id) {
+			return bits.Get(a_id, [&] {
+				++calls;
+				return a_id % 2 == 1;
+			});
+		};
+
+		CHECK(!is_odd(0));
+		CHECK(is_odd(1));
+		CHECK(is_odd(127));
+		CHECK(!is_odd(0));
+		CHECK(is_odd(1));
+		CHECK(is_odd(127));
+		CHECK(calls == 3);
+	}
+
+	// ids past N are evaluated every time
+	{
+		core::ResultBits<64> bits;
+		int                  calls = 0;
+		for (int i = 0; i < 3; ++i) {
+			CHECK(bits.Get(64, [&] {
+				++calls;
+				return true;
+			}));
+		}
+		CHECK(calls == 3);
+	}
+}
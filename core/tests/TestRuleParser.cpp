@@ -0,0 +1,131 @@
+#include "Test.h"
+
+#include <map>
+#include <string>
+#include <utility>
+
+#include "Core/RuleParser.h"
+
+using namespace std::literals;
+
+namespace
+{
+	// Fallout4.esm at index 0, Mod.esp at index 1
+	class StubFormLookup final : public core::FormLookup
+	{
+	public:
+		std::uint32_t LookupFormID(std::uint32_t a_localID, std::string_view a_plugin) const override
+		{
+			if (a_plugin == "Fallout4.esm"sv) {
+				return a_localID;
+			}
+			if (a_plugin == "Mod.esp"sv) {
+				return 0x01000000 | (a_localID & 0xFFFFFF);
+			}
+			return 0;
+		}
+
+		std::uint32_t LookupEditorID(std::string_view a_editorID) const override
+		{
+			return a_editorID == "NewRock"sv ? 0x01000800 : 0;
+		}
+
+		bool IsLoaded(std::uint32_t a_formID) const override
+		{
+			return a_formID < 0x02000000;
+		}
+
+		void Report(core::ParseError a_error, std::string_view a_entry) const override
+		{
+			errors.emplace_back(a_error, std::string(a_entry));
+		}
+
+		// members
+		mutable std::vector<std::pair<core::ParseError, std::string>> errors{};
+	};
+}
+
+void TestRuleParser()
+{
+	StubFormLookup lookup;
+
+	// formIDs
+	{
+		CHECK(core::ResolveFormID(lookup, "0x800~Mod.esp") == 0x01000800);
+		CHECK(core::ResolveFormID(lookup, "800~Mod.esp") == 0x01000800);
+		CHECK(core::ResolveFormID(lookup, "0x800~Missing.esp") == 0);
+		CHECK(core::ResolveFormID(lookup, "NewRock") == 0x01000800);
+		CHECK(core::ResolveFormID(lookup, "OldRock") == 0);
+		CHECK(core::ResolveFormID(lookup, "0x0001F4A2") == 0x0001F4A2);
+		CHECK(lookup.errors.empty());
+
+		// kept, so unloaded cells still match by formID
+		CHECK(core::ResolveFormID(lookup, "0x05000800") == 0x05000800);
+		CHECK(lookup.errors.size() == 1 && lookup.errors[0].first == core::ParseError::kFilterFormIDNotFound);
+		lookup.errors.clear();
+	}
+
+	// entries
+	{
+		CHECK(core::IsValidEntry("posA(0,0,10)"));
+		CHECK(!core::IsValidEntry(""));
+		CHECK(!core::IsValidEntry("NONE"));
+		CHECK(!core::IsValidEntry("none"));
+	}
+
+	// swap lines
+	{
+		const auto line = core::ParseSwapLine(lookup, "0x800~Mod.esp|NewRock|scale(2)|chance(50)");
+		CHECK(line && line->baseID == 0x01000800);
+		CHECK(line && !line->swapSet && line->swapIDs == std::vector<std::uint32_t>{ 0x01000800 });
+		CHECK(line && line->properties == "scale(2)"sv && line->chance == "chance(50)"sv);
+		CHECK(lookup.errors.empty());
+	}
+	{
+		const auto line = core::ParseSwapLine(lookup, "0x1F4A2~Fallout4.esm|0x801~Mod.esp,0x1~Missing.esp,0x802~Mod.esp");
+		CHECK(line && line->swapSet && line->swapIDs.size() == 2);
+		CHECK(line && line->properties.empty() && line->chance.empty());
+		CHECK(lookup.errors.size() == 1 && lookup.errors[0].first == core::ParseError::kSwapSetNotFound && lookup.errors[0].second == "0x1~Missing.esp");
+		lookup.errors.clear();
+	}
+	{
+		CHECK(!core::ParseSwapLine(lookup, "OldRock|NewRock"));
+		CHECK(!core::ParseSwapLine(lookup, "NewRock|OldRock"));
+		CHECK(!core::ParseSwapLine(lookup, "NewRock"));
+		CHECK(!core::ParseSwapLine(lookup, "NewRock|0x1~Missing.esp,0x2~Missing.esp"));
+		CHECK(!core::ParseSwapLine(lookup, "NewRock|NewRock|NONE"));
+		CHECK(lookup.errors.size() == 7);
+		CHECK(lookup.errors[0].first == core::ParseError::kBaseNotFound && lookup.errors[0].second == "OldRock|NewRock");
+		CHECK(lookup.errors[1].first == core::ParseError::kSwapNotFound);
+		CHECK(lookup.errors[2].first == core::ParseError::kSwapNotFound);
+		CHECK(lookup.errors[5].first == core::ParseError::kSwapNotFound);
+		CHECK(lookup.errors[6].first == core::ParseError::kBaseSameAsSwap);
+		lookup.errors.clear();
+
+		// same form is fine if it only changes properties
+		CHECK(core::ParseSwapLine(lookup, "NewRock|NewRock|scale(2)"));
+		CHECK(lookup.errors.empty());
+	}
+
+	// wildcard keys resolve BASE themselves
+	{
+		const auto line = core::ParseSwapFields(lookup, "keyword(LocTypeVault)|NewRock,0x801~Mod.esp||chance(10)");
+		CHECK(line && line->baseID == 0 && line->swapSet && line->swapIDs.size() == 2);
+		CHECK(line && line->properties.empty() && line->chance == "chance(10)"sv);
+
+		CHECK(!core::ParseSwapFields(lookup, "type(STAT)|OldRock"));
+		CHECK(lookup.errors.size() == 1 && lookup.errors[0].first == core::ParseError::kSwapNotFound);
+		lookup.errors.clear();
+	}
+
+	// property lines
+	{
+		const auto line = core::ParsePropertiesLine(lookup, "NewRock|posR(0,0,10), rotA(0,0,90)|chanceR(25)");
+		CHECK(line && line->baseID == 0x01000800 && line->swapIDs.empty());
+		CHECK(line && line->properties == "posR(0,0,10), rotA(0,0,90)"sv && line->chance == "chanceR(25)"sv);
+
+		CHECK(!core::ParsePropertiesLine(lookup, "OldRock|scale(2)"));
+		CHECK(lookup.errors.size() == 1 && lookup.errors[0].first == core::ParseError::kBaseNotFound);
+		lookup.errors.clear();
+	}
+}
@@ -0,0 +1,59 @@
+#include "Test.h"
+
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Core/ShardedTable.h"
+
+void TestShardedTable()
+{
+	using Table = core::ShardedTable<std::unordered_map<std::uint32_t, std::uint32_t>>;
+
+	// plugin formIDs share the high byte, they still spread over shards
+	{
+		Table                 table;
+		std::set<const void*> shards;
+		for (std::uint32_t i = 0; i < 256; ++i) {
+			const auto formID = 0x01000800 + i;
+			table.write(formID, [&](auto& a_map) {
+				a_map.emplace(formID, i);
+				shards.insert(&a_map);
+			});
+		}
+
+		CHECK(table.size() == 256);
+		CHECK(shards.size() == Table::shardCount);
+		CHECK(table.read(0x01000810, [](const auto& a_map) { return a_map.at(0x01000810); }) == 0x10);
+		CHECK(!table.read(0x02000800, [](const auto& a_map) { return a_map.contains(0x02000800); }));
+
+		std::size_t visited = 0;
+		table.for_each_shard([&](const auto& a_map) { visited += a_map.size(); });
+		CHECK(visited == 256);
+
+		table.clear();
+		CHECK(table.size() == 0);
+	}
+
+	// concurrent writers on disjoint keys, readers on the same table
+	{
+		Table                    table;
+		constexpr std::uint32_t  perThread = 2000;
+		std::vector<std::thread> threads;
+		for (std::uint32_t t = 0; t < 4; ++t) {
+			threads.emplace_back([&, t] {
+				for (std::uint32_t i = 0; i < perThread; ++i) {
+					const auto key = t * perThread + i;
+					table.write(key, [&](auto& a_map) { a_map.emplace(key, key); });
+					table.read(key / 2, [&](const auto& a_map) { return a_map.contains(key / 2); });
+				}
+			});
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+
+		CHECK(table.size() == 4 * perThread);
+	}
+}
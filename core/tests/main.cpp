@@ -0,0 +1,15 @@
+#include "Test.h"
+
+int main()
+{
+	TestCompiledFilters();
+	TestResultBits();
+	TestRuleParser();
+	TestShardedTable();
+
+	if (test::failures != 0) {
+		std::fprintf(stderr, "%d checks failed\n", test::failures);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
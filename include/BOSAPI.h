@@ -0,0 +1,82 @@
+#pragma once
+
+// Public interface for registering swap rules from other F4SE plugins.
+// This header is self-contained and can be copied into consuming projects.
+//
+// Resolve the exports with GetProcAddress(GetModuleHandle(L"po3_BaseObjectSwapperF4"), "BOS_RegisterRules")
+// and submit rules no later than kPostPostLoad; rules are merged once, when BOS reads its configs.
+
+#include <cstdint>
+
+namespace BOSAPI
+{
+	inline constexpr std::uint32_t VERSION = 1;
+
+	enum class RuleType : std::uint32_t
+	{
+		kForm,        // base or material swap formID -> swap forms
+		kReference,   // reference formID -> swap forms
+		kProperties,  // base, material swap or reference formID -> properties only
+	};
+
+	enum class ChanceType : std::uint32_t
+	{
+		kRandom,
+		kRefHash,
+		kLocationHash
+	};
+
+	struct FloatRange
+	{
+		float min;
+		float max;
+	};
+
+	struct Point3Range
+	{
+		FloatRange x;
+		FloatRange y;
+		FloatRange z;
+		bool       relative;
+	};
+
+	struct Properties
+	{
+		enum Flags : std::uint32_t
+		{
+			kNone = 0,
+			kLocation = 1 << 0,
+			kRotation = 1 << 1,
+			kScale = 1 << 2
+		};
+
+		std::uint32_t flags;  // which of the ranges below are set
+		Point3Range   location;
+		Point3Range   rotation;  // degrees
+		FloatRange    scale;
+		bool          scaleAbsolute;
+		std::uint32_t recordFlagsSet;
+		std::uint32_t recordFlagsUnset;
+	};
+
+	struct Rule
+	{
+		RuleType             type;
+		std::uint32_t        baseID;
+		const std::uint32_t* swapIDs;  // one entry swaps directly, more picks one at random
+		std::uint32_t        swapCount;
+		Properties           properties;
+		ChanceType           chanceType;
+		float                chance;        // 0-100
+		const std::uint32_t* matchFilters;  // LCTN, REGN, KYWD or CELL formIDs, any must match
+		std::uint32_t        matchCount;
+		const std::uint32_t* notFilters;  // none may match
+		std::uint32_t        notCount;
+	};
+
+	// a_priority < 0 : rules lose against INI rules
+	// a_priority >= 0 : rules win against INI rules
+	// batches with equal priority keep submission order, later batches win
+	using RegisterRules_t = bool (*)(const char* a_source, const Rule* a_rules, std::uint32_t a_count, std::int32_t a_priority);
+	using GetVersion_t = std::uint32_t (*)();
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Core/ShardedTable.h"
+
+// cell-scoped inputs of the condition filters
+struct CellData
+{
+	CellData() = default;
+	explicit CellData(RE::TESObjectCELL* a_cell);
+
+	[[nodiscard]] bool HasRegion(RE::FormID a_regionID) const { return std::ranges::binary_search(regionIDs, a_regionID); }
+
+	// members
+	std::vector<RE::FormID> regionIDs{};  // sorted
+};
+
+// CellData is built by the first ref of each cell, on the loader thread that attaches the cell,
+// and shared with the cell's other refs
+// refs hold their entry by shared_ptr, so Reset before a game load can drop the table while hooks still read it
+class CellDataCache : public ISingleton<CellDataCache>
+{
+public:
+	using Ptr = std::shared_ptr<const CellData>;
+
+	void Reset();
+
+	[[nodiscard]] Ptr Find(RE::TESObjectCELL* a_cell) const;
+	// returns the entry already there if another thread built the cell first
+	Ptr Insert(RE::TESObjectCELL* a_cell, CellData&& a_data);
+
+	void RecordMiss(std::uint64_t a_nanoseconds) const;
+
+	void LogStats();
+
+private:
+	// members
+	core::ShardedTable<FormIDMap<Ptr>> cells{};
+
+	mutable std::atomic<std::uint64_t> hits{ 0 };
+	mutable std::atomic<std::uint64_t> misses{ 0 };
+	mutable std::atomic<std::uint64_t> missTime{ 0 };
+};
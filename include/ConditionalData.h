@@ -1,14 +1,71 @@
 #pragma once
 
+#include "Core/CompiledFilters.h"
+#include "FilterProfile.h"
+#include "MemoryReport.h"
+#include "Settings.h"
+#include "SwapExplain.h"
+#include "RefContext.h"
+#include "SpatialIndex.h"
+
+using FilterData = std::variant<RE::FormID, std::string, SpatialID>;
+
+// load order independent key, 0xID~Plugin.esp, editorID or the spatial filter string
+std::string GetProfileKey(const FilterData& a_data);
+
+// conditional lists are partitioned by worldspace, interiors share one partition
+inline constexpr RE::FormID kInteriorScope{ 0 };
+
+// worldspace a MATCH atom can only pass in, cells, regions and spatial filters
+// nullopt if the atom can pass anywhere (locations, keywords, editorIDs)
+std::optional<RE::FormID> GetFilterScope(const FilterData& a_data);
+
 struct ConditionFilters
 {
 public:
 	ConditionFilters() = default;
 	ConditionFilters(std::vector<std::string>& a_conditions);
 
+	bool operator==(const ConditionFilters& a_rhs) const
+	{
+		return NOT == a_rhs.NOT && MATCH == a_rhs.MATCH;
+	}
+
+	// independent of atom order
+	[[nodiscard]] std::string GetProfileKey() const;
+
+	// members
+	std::vector<FilterData> NOT{};
+	std::vector<FilterData> MATCH{};
+	std::uint32_t           id{ 0 };  // assigned by ConditionFilterRegistry
+};
+
+// identical condition headers share one canonical filter set
+// sets are only interned while loading, so the returned pointers can be read without locking
+class ConditionFilterRegistry : public ISingleton<ConditionFilterRegistry>
+{
+public:
+	const ConditionFilters* Intern(const ConditionFilters& a_filters);
+
+	// renumbers sets by how many headers share them, so the most shared sets get the per-ref cached IDs
+	void AssignIDs();
+
+	// NOT and MATCH are both any-of, so atoms can run in any order
+	// sorts them by expected cost per hit from the filter profile, cheap selective atoms first
+	void OrderAtoms();
+
+	[[nodiscard]] std::size_t size() const { return filterSets.size(); }
+	[[nodiscard]] std::size_t GetInternCount() const { return internCount; }
+	[[nodiscard]] std::size_t GetHeapBytes() const;
+
+private:
+	static std::uint64_t hash(const ConditionFilters& a_filters);
+
 	// members
-	std::vector<FormIDStr> NOT{};
-	std::vector<FormIDStr> MATCH{};
+	std::deque<ConditionFilters>                   filterSets{};
+	std::vector<std::uint32_t>                     uses{};
+	Map<std::uint64_t, std::vector<std::uint32_t>> buckets{};
+	std::size_t                                    internCount{ 0 };
 };
 
 template <class T>
@@ -16,37 +73,297 @@ struct ConditionalData
 {
 public:
 	ConditionalData() = default;
-	ConditionalData(const ConditionFilters& a_filters, const T& a_data) :
+	ConditionalData(const ConditionFilters* a_filters, const T& a_data) :
 		filters(a_filters)
 	{
 		data.push_back(a_data);
 	}
+	ConditionalData(const ConditionFilters& a_filters, const T& a_data) :
+		ConditionalData(ConditionFilterRegistry::GetSingleton()->Intern(a_filters), a_data)
+	{}
 
 	// members
-	ConditionFilters filters;
-	std::vector<T>   data;
+	const ConditionFilters* filters{ nullptr };
+	std::vector<T>          data;
 };
 
 struct ConditionalInput
 {
-	ConditionalInput(const RE::TESObjectREFR* a_ref, const RE::TESForm* a_form) :
-		ref(a_ref),
-		base(a_form),
-		currentCell(a_ref->GetSaveParentCell()),
-		currentLocation(a_ref->GetCurrentLocation()),
-		currentRegionList(currentCell ? currentCell->GetRegionList(false): nullptr)
+	explicit ConditionalInput(const RefContext& a_context) :
+		context(a_context)
 	{}
 
 	[[nodiscard]] bool IsValid(RE::FormID a_formID) const;
 	[[nodiscard]] bool IsValid(const std::string& a_edid) const;
+	[[nodiscard]] bool IsValid(SpatialID a_spatialID) const;
 
-	[[nodiscard]] bool IsValid(const FormIDStr& a_data) const;
+	[[nodiscard]] bool IsValid(const FilterData& a_data) const;
 	[[nodiscard]] bool IsValid(const ConditionFilters& a_filters) const;
+	// same result, without the per-ref filter set cache
+	[[nodiscard]] bool IsValidUncached(const ConditionFilters& a_filters) const;
+
+	// worldspace of the ref's cell or kInteriorScope, nullopt if the ref has no cell
+	[[nodiscard]] std::optional<RE::FormID> GetScope() const;
+
+	// members
+	const RefContext& context;
+};
+
+// conditional entries for one base, last entry wins
+// Compile() interns the filter atoms of every entry, so Find() tests each distinct atom at most once per ref
+// whole filter sets are cached on the ref context by ID, and shared across lists
+// entries whose MATCH atoms all imply a worldspace are only searched for refs in it
+template <class T>
+class ConditionalList
+{
+public:
+	using value_type = ConditionalData<T>;
+	using iterator = typename std::vector<value_type>::iterator;
+	using const_iterator = typename std::vector<value_type>::const_iterator;
+
+	template <class... Args>
+	value_type& emplace_back(Args&&... a_args)
+	{
+		return entries.emplace_back(std::forward<Args>(a_args)...);
+	}
+
+	void push_back(const value_type& a_value) { entries.push_back(a_value); }
+	void push_back(value_type&& a_value) { entries.push_back(std::move(a_value)); }
+	void reserve(std::size_t a_size) { entries.reserve(a_size); }
+
+	[[nodiscard]] std::size_t size() const { return entries.size(); }
+	[[nodiscard]] bool        empty() const { return entries.empty(); }
+
+	iterator       begin() { return entries.begin(); }
+	iterator       end() { return entries.end(); }
+	const_iterator begin() const { return entries.begin(); }
+	const_iterator end() const { return entries.end(); }
+
+	void Compile(RE::FormID a_key)
+	{
+		compiled.clear();
+		compiled.reserve(entries.size());
+		for (const auto& entry : entries) {
+			compiled.Add(entry.filters->NOT, entry.filters->MATCH);
+		}
+		compiled.shrink_to_fit();
+
+		BuildPartitions();
+
+		profileKey = GetProfileKey(a_key);
+		if (Settings::GetSingleton()->profileFilters) {
+			const auto profile = FilterProfile::GetSingleton();
+			listSlot = profile->GetSlot(GetListProfileKey());
+			entrySlots.clear();
+			for (std::size_t i = 0; i < entries.size(); ++i) {
+				entrySlots.push_back(profile->GetSlot(GetEntryProfileKey(i)));
+			}
+			atomSlots.clear();
+			for (const auto& atom : compiled.GetAtoms()) {
+				atomSlots.push_back(profile->GetSlot(GetProfileKey(atom)));
+			}
+		}
+	}
+
+	[[nodiscard]] std::size_t GetAtomCount() const { return compiled.GetAtomCount(); }
+	[[nodiscard]] std::size_t GetFilterCount() const { return compiled.GetFilterCount(); }
+
+	// worldspace partitions, 0 if every entry can pass anywhere
+	[[nodiscard]] std::size_t GetPartitionCount() const { return partitions.size(); }
+	// mean entries searched per ref, over the worldspace partitions and the remaining worldspaces
+	[[nodiscard]] double GetAverageCandidates() const
+	{
+		if (partitions.empty()) {
+			return static_cast<double>(entries.size());
+		}
+		std::size_t candidates = unscoped.size();
+		for (const auto& partition : partitions | std::views::values) {
+			candidates += partition.size();
+		}
+		return static_cast<double>(candidates) / static_cast<double>(partitions.size() + 1);
+	}
+
+	// entries, compiled filters and profiling slots, excluding heap memory owned by the entries' data
+	[[nodiscard]] std::size_t GetHeapBytes() const
+	{
+		std::size_t bytes = entries.capacity() * sizeof(value_type) + compiled.GetHeapBytes();
+		for (const auto& entry : entries) {
+			bytes += (entry.data.capacity() - entry.data.size()) * sizeof(T);
+		}
+		bytes += MemoryReport::table_bytes(partitions) + unscoped.capacity() * sizeof(std::uint32_t);
+		for (const auto& partition : partitions | std::views::values) {
+			bytes += partition.capacity() * sizeof(std::uint32_t);
+		}
+		return bytes + (entrySlots.capacity() + atomSlots.capacity()) * sizeof(std::uint32_t) + profileKey.capacity();
+	}
+
+	// searches of the whole list, hits are searches that found an entry
+	[[nodiscard]] std::string GetListProfileKey() const { return std::format("list|{}", profileKey); }
+	// checks of one entry, hits are checks its filters passed
+	[[nodiscard]] std::string GetEntryProfileKey(std::size_t a_index) const
+	{
+		const auto& entry = entries[a_index];
+		return std::format("rule|{}|{}|{}", profileKey, entry.filters->GetProfileKey(), entry.data.empty() ? std::string{} : entry.data.front().path);
+	}
+
+	const value_type* Find(const ConditionalInput& a_input) const
+	{
+		NoExplain explain;
+		return Find(a_input, explain);
+	}
+
+	template <class Explain>
+	const value_type* Find(const ConditionalInput& a_input, Explain& a_explain) const
+	{
+		if (compiled.size() != entries.size()) {
+			const auto it = std::ranges::find_if(entries | std::views::reverse, [&](const auto& a_entry) { return a_input.IsValid(*a_entry.filters); });
+			return it != entries.rend() ? std::addressof(*it) : nullptr;
+		}
+
+		const auto candidates = GetCandidates(a_input);
+		const auto find_last = [&](auto&& a_isAtomValid, auto&& a_isEntryValid) {
+			return candidates ? compiled.FindLast(*candidates, a_isAtomValid, a_isEntryValid) : compiled.FindLast(a_isAtomValid, a_isEntryValid);
+		};
+
+		if constexpr (Explain::enabled) {
+			if (candidates) {
+				a_explain.Log("worldspace partition : {} of {} entries", candidates->size(), entries.size());
+			}
+			const auto index = find_last(
+				[&](std::uint32_t, const FilterData& a_filter) {
+					const auto start = std::chrono::steady_clock::now();
+					const auto result = a_input.IsValid(a_filter);
+					const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+					a_explain.Log("{} : {} ({} ns)", GetProfileKey(a_filter), result, elapsed);
+					return result;
+				},
+				[&](std::size_t a_index, const auto& a_evaluate) {
+					const auto& entry = entries[a_index];
+					bool        result = false;
+					{
+						[[maybe_unused]] const auto stage = a_explain.BeginStage(std::format("filters {}", entry.filters->GetProfileKey()));
+						result = a_input.context.GetFilterSetResult(entry.filters->id, a_evaluate);
+					}
+					a_explain.Log("{} : {}", entry.data.empty() ? std::string{} : entry.data.front().path, result ? "passed" : "failed");
+					return result;
+				});
+
+			return index ? std::addressof(entries[*index]) : nullptr;
+		}
+
+		const auto profile = FilterProfile::GetSingleton();
+		if (!profile->IsEnabled()) {
+			const auto index = find_last(
+				[&](std::uint32_t, const FilterData& a_filter) { return a_input.IsValid(a_filter); },
+				[&](std::size_t a_index, const auto& a_evaluate) { return a_input.context.GetFilterSetResult(entries[a_index].filters->id, a_evaluate); });
+
+			return index ? std::addressof(entries[*index]) : nullptr;
+		}
+
+		const auto index = find_last(
+			[&](std::uint32_t a_atom, const FilterData& a_filter) {
+				const auto start = std::chrono::steady_clock::now();
+				const auto result = a_input.IsValid(a_filter);
+				profile->Record(atomSlots[a_atom], result, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+				return result;
+			},
+			[&](std::size_t a_index, const auto& a_evaluate) {
+				const auto result = a_input.context.GetFilterSetResult(entries[a_index].filters->id, a_evaluate);
+				profile->Record(entrySlots[a_index], result);
+				return result;
+			});
+		profile->Record(listSlot, index.has_value());
+
+		return index ? std::addressof(entries[*index]) : nullptr;
+	}
+
+	// unoptimized baseline for shadow mode, every entry from the back with its filters evaluated directly
+	// no atom interning, worldspace partitions or filter set cache
+	template <class Explain>
+	const value_type* FindReference(const ConditionalInput& a_input, Explain& a_explain) const
+	{
+		for (const auto& entry : entries | std::views::reverse) {
+			const bool result = a_input.IsValidUncached(*entry.filters);
+			if constexpr (Explain::enabled) {
+				a_explain.Log("{} {} : {}", entry.filters->GetProfileKey(), entry.data.empty() ? std::string{} : entry.data.front().path, result ? "passed" : "failed");
+			}
+			if (result) {
+				return std::addressof(entry);
+			}
+		}
+		return nullptr;
+	}
+
+private:
+	void BuildPartitions()
+	{
+		partitions.clear();
+		unscoped.clear();
+
+		// worldspaces each entry is limited to, empty if it can pass anywhere
+		std::vector<std::vector<RE::FormID>> entryScopes(entries.size());
+		for (std::size_t i = 0; i < entries.size(); ++i) {
+			auto& scopes = entryScopes[i];
+			for (const auto& filter : entries[i].filters->MATCH) {
+				const auto scope = GetFilterScope(filter);
+				if (!scope) {
+					scopes.clear();
+					break;
+				}
+				scopes.push_back(*scope);
+			}
+			for (const auto scope : scopes) {
+				partitions.try_emplace(scope);
+			}
+		}
+
+		if (partitions.empty()) {
+			return;
+		}
+
+		// unscoped entries go into every partition, indices stay ascending so the last entry still wins
+		for (std::uint32_t i = 0; i < entries.size(); ++i) {
+			if (entryScopes[i].empty()) {
+				unscoped.push_back(i);
+				for (auto& partition : partitions | std::views::values) {
+					partition.push_back(i);
+				}
+			} else {
+				for (const auto scope : entryScopes[i]) {
+					if (auto& partition = partitions[scope]; partition.empty() || partition.back() != i) {
+						partition.push_back(i);
+					}
+				}
+			}
+		}
+
+		unscoped.shrink_to_fit();
+		for (auto& partition : partitions | std::views::values) {
+			partition.shrink_to_fit();
+		}
+	}
+
+	// nullopt searches every entry
+	[[nodiscard]] std::optional<std::span<const std::uint32_t>> GetCandidates(const ConditionalInput& a_input) const
+	{
+		if (partitions.empty()) {
+			return std::nullopt;
+		}
+		const auto scope = a_input.GetScope();
+		if (!scope) {
+			return std::nullopt;
+		}
+		const auto it = partitions.find(*scope);
+		return it != partitions.end() ? std::span<const std::uint32_t>(it->second) : std::span<const std::uint32_t>(unscoped);
+	}
 
 	// members
-	const RE::TESObjectREFR* ref;
-	const RE::TESForm*       base;
-	RE::TESObjectCELL*       currentCell;
-	RE::BGSLocation*         currentLocation;
-	RE::TESRegionList*       currentRegionList;
+	std::vector<value_type>               entries{};
+	core::CompiledFilterList<FilterData>  compiled{};
+	std::string                           profileKey{};
+	std::uint32_t                         listSlot{ 0 };
+	std::vector<std::uint32_t>            entrySlots{};
+	std::vector<std::uint32_t>            atomSlots{};
+	FormIDMap<std::vector<std::uint32_t>> partitions{};
+	std::vector<std::uint32_t>            unscoped{};  // searched in worldspaces without a partition
 };
@@ -0,0 +1,38 @@
+#pragma once
+
+// rules for the same key, and for conditional sections the same filter set, where the last rule always wins
+// built on a worker thread after the rule maps are published, rules are views into their records and paths
+//
+// {PROJECT}_Conflicts.csv in the log directory, one row per rule of each conflict
+// rows are sorted by section, key and filters, with load order independent keys, so reports diff across load orders
+// section,key,filters,result,record,path
+class ConflictReport
+{
+public:
+	struct Rule
+	{
+		std::string_view record;
+		std::string_view path;
+		float            chance;
+	};
+
+	// a_rules in load order, kept if the last rule isn't randomized and shadows at least one other
+	void Add(std::string_view a_section, std::string a_key, std::string a_filters, std::span<const Rule> a_rules);
+
+	// logs one line per conflict and writes the CSV, returns the number of conflicts
+	std::size_t Write();
+
+private:
+	struct Conflict
+	{
+		std::string_view  section;
+		std::string       key;
+		std::string       filters;
+		std::vector<Rule> rules;
+	};
+
+	static std::filesystem::path get_path();
+
+	// members
+	std::vector<Conflict> conflicts{};
+};
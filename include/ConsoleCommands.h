@@ -0,0 +1,8 @@
+#pragma once
+
+// bos explain : traces the swap rules for the selected reference
+// bos memory  : writes the rule memory report to the log
+namespace ConsoleCommands
+{
+	void Install();
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+// per-atom and per-rule counters for conditional filters, keyed by load order independent strings
+// counters are added to the profile from earlier sessions and written back, so they accumulate across sessions
+// the accumulated profile orders filter atoms at load and flags conditional rules that never matched
+//
+// Data\F4SE\Plugins\po3_BaseObjectSwapperF4.ini
+// [Debug]
+// bProfileFilters = true
+class FilterProfile : public ISingleton<FilterProfile>
+{
+public:
+	struct Counters
+	{
+		std::uint64_t evaluations{ 0 };
+		std::uint64_t hits{ 0 };
+		std::uint64_t nanoseconds{ 0 };
+	};
+
+	// reads the accumulated profile, used for ordering even when profiling is off
+	void Load();
+	// allocates counters for the registered slots, profiling stays off unless enabled in settings
+	void Start();
+	// writes the earlier sessions' profile plus this session's counters, safe to call repeatedly
+	// called after each save and load, not from a DLL exit handler
+	void Save() const;
+
+	[[nodiscard]] bool IsEnabled() const { return enabled; }
+
+	// load time only
+	std::uint32_t                          GetSlot(const std::string& a_key);
+	[[nodiscard]] std::optional<Counters> GetProfile(const std::string& a_key) const;
+
+	// expected cost of an atom per hit, lower runs first
+	// a_defaultCost is used until the atom has enough samples
+	[[nodiscard]] double GetScore(const std::string& a_key, double a_defaultCost) const;
+
+	void Record(std::uint32_t a_slot, bool a_hit) const;
+	void Record(std::uint32_t a_slot, bool a_hit, std::uint64_t a_nanoseconds) const;
+
+private:
+	struct Slot
+	{
+		std::atomic<std::uint64_t> evaluations{ 0 };
+		std::atomic<std::uint64_t> hits{ 0 };
+		std::atomic<std::uint64_t> nanoseconds{ 0 };
+	};
+
+	static std::filesystem::path get_path();
+
+	static constexpr std::uint64_t minSamples{ 100 };
+
+	// members
+	Map<std::string, Counters>      profile{};
+	Map<std::string, std::uint32_t> slotIndices{};
+	std::vector<std::string>        slotKeys{};
+	std::unique_ptr<Slot[]>         slots{};
+	bool                            enabled{ false };
+};
@@ -7,6 +7,21 @@ namespace BaseObjectSwapper
 	namespace detail
 	{
 		void swap_base(RE::TESObjectREFR* a_ref);
+
+		// projectile/hazard spawns, skips swap_base unless a rule can apply to this hook
+		void swap_spawned_base(RE::TESObjectREFR* a_ref, FormSwap::HOOK_TYPE a_type);
+
+		template <class T>
+		consteval FormSwap::HOOK_TYPE get_hook_type()
+		{
+			if constexpr (std::is_same_v<T, RE::ArrowProjectile>) {
+				return FormSwap::HOOK_TYPE::kProjectile;
+			} else if constexpr (std::is_same_v<T, RE::Hazard>) {
+				return FormSwap::HOOK_TYPE::kHazard;
+			} else {
+				return FormSwap::HOOK_TYPE::kReference;
+			}
+		}
 	}
 
 	template <class T>
@@ -14,12 +29,17 @@ namespace BaseObjectSwapper
 	{
 		static void thunk(T* a_ref)
 		{
-			detail::swap_base(a_ref);
+			if constexpr (type == FormSwap::HOOK_TYPE::kReference) {
+				detail::swap_base(a_ref);
+			} else {
+				detail::swap_spawned_base(a_ref, type);
+			}
 
 			func(a_ref);
 		}
 		static inline REL::Relocation<decltype(thunk)> func;
 		static inline constexpr std::size_t size{ 0x16 };
+		static inline constexpr auto        type{ detail::get_hook_type<T>() };
 
 		static void Install()
 		{
@@ -49,4 +69,7 @@ namespace BaseObjectSwapper
 	};
 
 	void Install();
+
+	// projectile/hazard spawn counts and average cost since the last call
+	void LogStats();
 }
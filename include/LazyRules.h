@@ -0,0 +1,207 @@
+#pragma once
+
+#include "LoadErrors.h"
+#include "MemoryReport.h"
+
+namespace FormSwap
+{
+	// [Forms], [References] and [Properties] lines, indexed by key while loading and parsed the first time the key is looked up
+	// lines keep their INI order per key, so a compiled key holds the same rules, in the same order, as an eagerly loaded one
+	template <class T>
+	class LazyRuleMap
+	{
+	public:
+		// SwapFormData::GetForms or ObjectData::GetProperties
+		using Parse = void (*)(const std::string&, const std::string&, std::function<void(RE::FormID, T&)>);
+		// runs once per key after parsing, on the thread that looked it up
+		using Finalize = std::function<void(std::vector<T>&)>;
+
+		explicit LazyRuleMap(Parse a_parse) :
+			parse(a_parse)
+		{}
+
+		void SetFinalize(Finalize a_finalize) { finalize = std::move(a_finalize); }
+
+		// lines added after this belong to a_path
+		void BeginFile(const std::string& a_path)
+		{
+			paths.push_back(a_path);
+			text.emplace_back();
+		}
+
+		// key lookup only, the rest of the line is parsed on first use
+		void Add(const std::string& a_line)
+		{
+			const auto formID = util::GetFormID(a_line.substr(0, a_line.find('|')));
+			if (formID == 0) {
+				LoadErrors::GetSingleton()->Report(LoadErrors::TYPE::kBaseNotFound, a_line);
+				return;
+			}
+
+			auto& fileText = text.back();
+			const Span span{ static_cast<std::uint32_t>(paths.size() - 1), static_cast<std::uint32_t>(fileText.size()), static_cast<std::uint32_t>(a_line.size()) };
+			fileText.append(a_line);
+
+			const auto [it, inserted] = slotIndices.try_emplace(formID, static_cast<std::uint32_t>(slots.size()));
+			if (inserted) {
+				slots.emplace_back();
+			}
+			slots[it->second].spans.push_back(span);
+			lines++;
+		}
+
+		void shrink_to_fit()
+		{
+			for (auto& fileText : text) {
+				fileText.shrink_to_fit();
+			}
+			for (auto& slot : slots) {
+				slot.spans.shrink_to_fit();
+			}
+		}
+
+		// rules of a_formID, compiled on first call, nullptr if the key has no rules left
+		const std::vector<T>* find(RE::FormID a_formID) const
+		{
+			const auto it = slotIndices.find(a_formID);
+			if (it == slotIndices.end()) {
+				return nullptr;
+			}
+			const auto& slot = slots[it->second];
+			std::call_once(slot.once, [&] {
+				slot.rules = parse_spans(slot);
+				if (finalize) {
+					finalize(slot.rules);
+				}
+				slot.rules.shrink_to_fit();
+				compiledKeys.fetch_add(1, std::memory_order_relaxed);
+				slot.compiled.store(true, std::memory_order_release);
+			});
+			return slot.rules.empty() ? nullptr : std::addressof(slot.rules);
+		}
+
+		// parses a_formID now and drops it from the index, for keys that must be loaded eagerly
+		std::vector<T> extract(RE::FormID a_formID)
+		{
+			const auto it = slotIndices.find(a_formID);
+			if (it == slotIndices.end()) {
+				return {};
+			}
+			auto rules = parse_spans(slots[it->second]);
+			lines -= slots[it->second].spans.size();
+			slots[it->second].spans = {};
+			slotIndices.erase(it);
+			return rules;
+		}
+
+		[[nodiscard]] std::vector<RE::FormID> keys() const
+		{
+			std::vector<RE::FormID> result;
+			result.reserve(slotIndices.size());
+			for (const auto formID : slotIndices | std::views::keys) {
+				result.push_back(formID);
+			}
+			return result;
+		}
+
+		[[nodiscard]] std::size_t size() const { return slotIndices.size(); }
+		[[nodiscard]] bool        empty() const { return slotIndices.empty(); }
+		[[nodiscard]] std::size_t GetLineCount() const { return lines; }
+		[[nodiscard]] std::size_t GetCompiledCount() const { return compiledKeys.load(std::memory_order_relaxed); }
+
+		struct Line
+		{
+			std::string_view path;
+			std::string_view text;
+		};
+
+		// a_func(formID, std::span<const Line>) for keys with more than one line, in INI order and without parsing them
+		template <class F>
+		void ForEachMultiLine(F&& a_func) const
+		{
+			std::vector<Line> lines;
+			for (const auto& [formID, index] : slotIndices) {
+				const auto& spans = slots[index].spans;
+				if (spans.size() < 2) {
+					continue;
+				}
+				lines.clear();
+				for (const auto& [file, offset, length] : spans) {
+					lines.push_back({ paths[file], std::string_view(text[file]).substr(offset, length) });
+				}
+				a_func(formID, std::span<const Line>(lines));
+			}
+		}
+
+		// a_func(formID, std::vector<T>&&) for every key, parsed now and separately from the copy find compiles
+		template <class F>
+		void ForEachParsed(F&& a_func) const
+		{
+			for (const auto& [formID, index] : slotIndices) {
+				a_func(formID, parse_spans(slots[index]));
+			}
+		}
+
+		// a_func(const T&) for every rule of the keys compiled so far
+		template <class F>
+		void ForEachCompiled(F&& a_func) const
+		{
+			for (const auto& slot : slots) {
+				if (slot.compiled.load(std::memory_order_acquire)) {
+					std::ranges::for_each(slot.rules, a_func);
+				}
+			}
+		}
+
+		// index and line text, excluding compiled rules
+		[[nodiscard]] std::size_t GetHeapBytes() const
+		{
+			std::size_t bytes = MemoryReport::table_bytes(slotIndices) + slots.size() * sizeof(Slot) + MemoryReport::vector_bytes(text);
+			for (const auto& slot : slots) {
+				bytes += MemoryReport::vector_bytes(slot.spans);
+			}
+			for (std::size_t i = 0; i < paths.size(); ++i) {
+				bytes += MemoryReport::string_bytes(paths[i]) + MemoryReport::string_bytes(text[i]);
+			}
+			return bytes;
+		}
+
+	private:
+		struct Span
+		{
+			std::uint32_t file;
+			std::uint32_t offset;
+			std::uint32_t length;
+		};
+
+		struct Slot
+		{
+			std::vector<Span>         spans{};
+			mutable std::once_flag    once{};
+			mutable std::vector<T>    rules{};
+			mutable std::atomic<bool> compiled{ false };
+		};
+
+		std::vector<T> parse_spans(const Slot& a_slot) const
+		{
+			std::vector<T> rules;
+			rules.reserve(a_slot.spans.size());
+			for (const auto& [file, offset, length] : a_slot.spans) {
+				parse(paths[file], text[file].substr(offset, length), [&](RE::FormID, T& a_rule) {
+					rules.push_back(a_rule);
+				});
+			}
+			return rules;
+		}
+
+		// members
+		Parse                            parse;
+		Finalize                         finalize{};
+		std::vector<std::string>         paths{};
+		std::vector<std::string>         text{};  // indexed lines of each file, back to back
+		FormIDMap<std::uint32_t>         slotIndices{};
+		std::deque<Slot>                 slots{};
+		std::size_t                      lines{ 0 };
+		mutable std::atomic<std::size_t> compiledKeys{ 0 };
+	};
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "RNG.h"
+
+namespace FormSwap
+{
+	// swap target leveled list, flattened after data load
+	// every player level bracket maps to a table of (cumulative weight, object), so a pick is two binary searches
+	class FlatLeveledList
+	{
+	public:
+		FlatLeveledList() = default;
+		explicit FlatLeveledList(const RE::TESLevItem* a_list);
+
+		[[nodiscard]] bool IsValid(const RE::TESLevItem* a_list) const;
+		[[nodiscard]] bool empty() const;
+
+		RE::TESBoundObject* Pick(std::uint16_t a_level, const BOS_RNG& a_rng) const;
+
+	private:
+		struct Candidate
+		{
+			float               cumulativeWeight;
+			RE::TESBoundObject* object;
+		};
+
+		struct Bracket
+		{
+			std::uint16_t minLevel;
+			std::uint32_t begin;
+			std::uint32_t end;
+		};
+
+		static void CollectLevels(const RE::TESLeveledList* a_list, std::vector<std::uint16_t>& a_levels, std::uint32_t a_depth);
+		static bool IsFlattenable(const RE::TESLeveledList* a_list, std::uint32_t a_depth);
+
+		void Resolve(const RE::TESLeveledList* a_list, std::uint16_t a_level, float a_weight, std::uint32_t a_depth);
+		void AddEntry(const RE::LEVELED_OBJECT& a_entry, std::uint16_t a_level, float a_weight, std::uint32_t a_depth);
+
+		// members
+		std::vector<Bracket>   brackets{};  // sorted by minLevel
+		std::vector<Candidate> candidates{};
+		std::int8_t            scriptListCount{ 0 };
+	};
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+// per-entry failures while reading configs
+// the first few of each kind are logged per INI, the rest are folded into a summary
+// lazily loaded rules report from loader threads, so reports are locked
+class LoadErrors : public ISingleton<LoadErrors>
+{
+public:
+	enum class TYPE : std::uint32_t
+	{
+		kBaseNotFound,
+		kSwapNotFound,
+		kSwapSetNotFound,
+		kSwapDeleted,
+		kSwapNotBoundObject,
+		kBaseSameAsSwap,
+		kFilterNotFound,
+		kFilterFormIDNotFound,
+		kSpatialMalformed,
+		kSpatialWorldspaceNotFound,
+		kSpatialArguments,
+
+		kTotal
+	};
+
+	void Report(TYPE a_type, std::string_view a_entry);
+	void LogSummary();
+
+private:
+	static constexpr std::uint32_t maxLinesPerType{ 5 };
+
+	// members
+	std::array<std::uint32_t, std::to_underlying(TYPE::kTotal)> counts{};
+	std::mutex                                                  lock{};
+};
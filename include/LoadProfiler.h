@@ -0,0 +1,58 @@
+#pragma once
+
+// per parser stage throughput, collected while LoadForms runs and when lazily loaded rules are parsed
+// timers are no-ops unless enabled, the parsers run them on every call
+//
+// Data\F4SE\Plugins\po3_BaseObjectSwapperF4.ini
+// [Debug]
+// bProfileLoad = true
+class LoadProfiler : public ISingleton<LoadProfiler>
+{
+public:
+	enum class STAGE : std::uint32_t
+	{
+		kReadINI,
+		kConditionFilters,
+		kGetForms,
+		kGetProperties,
+		kSplitWithRegex,
+
+		kTotal
+	};
+
+	class ScopedTimer
+	{
+	public:
+		ScopedTimer(STAGE a_stage, std::size_t a_bytes, std::size_t a_entries = 1);
+		~ScopedTimer();
+
+		ScopedTimer(const ScopedTimer&) = delete;
+		ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+	private:
+		// members
+		STAGE                                 stage;
+		std::size_t                           bytes;
+		std::size_t                           entries;
+		bool                                  enabled;
+		std::chrono::steady_clock::time_point start{};
+	};
+
+	[[nodiscard]] static bool IsEnabled();
+
+	void Record(STAGE a_stage, std::chrono::nanoseconds a_time, std::size_t a_bytes, std::size_t a_entries);
+	void LogResults() const;
+
+private:
+	struct Stats
+	{
+		std::uint64_t nanoseconds{ 0 };
+		std::uint64_t bytes{ 0 };
+		std::uint64_t entries{ 0 };
+		std::uint64_t calls{ 0 };
+	};
+
+	// members
+	std::array<Stats, std::to_underlying(STAGE::kTotal)> stats{};
+	mutable std::mutex                                   lock{};
+};
@@ -1,38 +1,171 @@
 #pragma once
 
+#include "BOSAPI.h"
+#include "Core/ShardedTable.h"
+#include "LazyRules.h"
+#include "LeveledList.h"
 #include "SwapData.h"
+#include "WildcardIndex.h"
 
 namespace FormSwap
 {
+	// InitItemImpl hook a ref was spawned through
+	enum class HOOK_TYPE : std::uint32_t
+	{
+		kReference,
+		kProjectile,
+		kHazard,
+
+		kTotal
+	};
+
+	// rule engine GetSwapData evaluates with
+	// the reference engine is the unoptimized baseline shadow mode compares the compiled one against :
+	// uncached conditional list scans, eagerly parsed rules instead of lazy keys, and the game's leveled list pick
+	enum class ENGINE
+	{
+		kCompiled,
+		kReference
+	};
+
 	class Manager : public ISingleton<Manager>
 	{
 	public:
 		void LoadFormsOnce();
 
+		// prints once conflict analysis has finished and found conflicts
 		void PrintConflicts() const;
 
-		SwapFormResult GetSwapData(RE::TESObjectREFR* a_ref, const RE::TESForm* a_base, const RE::BGSMaterialSwap* a_materialSwap);
+		// bytes per rule map and per source file, written after loading and on every game load
+		void LogMemoryReport() const;
+
+		bool RegisterRules(std::string_view a_source, std::span<const BOSAPI::Rule> a_rules, std::int32_t a_priority);
 
-		SwapFormResult GetSwapFormConditional(const RE::TESObjectREFR* a_ref, const RE::TESForm* a_base, const RE::BGSMaterialSwap* a_materialSwap);
-		std::optional<ObjectProperties> GetObjectPropertiesConditional(const RE::TESObjectREFR* a_ref, const RE::TESForm* a_base, const RE::BGSMaterialSwap* a_materialSwap);
+		// false if no rule can apply to refs spawned through this hook, references always pass
+		bool HasHookRules(HOOK_TYPE a_type, const RE::TESObjectREFR* a_ref) const;
+
+		// the ref's swap decision if it has one, otherwise the rules are evaluated
+		// sampled refs are also run through the reference engine in shadow mode, the compiled result is returned
+		SwapFormResult GetSwapData(const RefContext& a_context, const RE::BGSMaterialSwap* a_materialSwap);
+
+		// evaluates the rules for a_ref's original base with tracing, ignoring its swap decision,
+		// and prints every stage, filter, chance roll and winner with timings
+		// nothing is applied to the ref
+		void ExplainSwapData(RE::TESObjectREFR* a_ref);
 
 		void InsertLeveledItemRef(const RE::TESObjectREFR* a_refr);
 		bool IsLeveledItemRefSwapped(const RE::TESObjectREFR* a_refr) const;
 
+		// created refs are skipped, their formIDs are recycled
+		void InsertSwapDecision(const RefContext& a_context, const SwapFormResult& a_swapData);
+		// nullopt if the ref has no decision, or its base no longer matches the one it was swapped from
+		std::optional<SwapFormResult> GetSwapDecision(const RefContext& a_context) const;
+		// any base
+		std::optional<SwapDecision> FindSwapDecision(RE::FormID a_refID) const;
+
+		// co-save
+		std::vector<std::pair<RE::FormID, SwapDecision>> GetSwapDecisions() const;
+		std::vector<RE::FormID>                          GetLeveledItemRefs() const;
+		void                                             RestoreSwapDecisions(FormIDMap<SwapDecision>&& a_decisions, Set<RE::FormID>&& a_leveledItemRefs);
+		void                                             ClearSwapDecisions();
+
+		// changes when a _SWAP.ini is added, removed or edited, or an API batch changes
+		// decisions saved under another fingerprint are dropped, the rules that made them may be gone
+		std::uint64_t GetRulesFingerprint() const { return rulesFingerprint; }
+
 	private:
+		// rules submitted through the API, merged into the maps below in one pass
+		struct RuleBatch
+		{
+			std::string  source{};
+			std::int32_t priority{ 0 };
+			std::size_t  count{ 0 };
+
+			FormIDMap<SwapFormDataVec>                       swapRefs{};
+			FormIDMap<SwapFormDataConditionalVec> swapFormsConditional{};
+			FormIDMap<SwapFormDataVec>                       swapForms{};
+
+			FormIDMap<ObjectDataVec>                       refProperties{};
+			FormIDMap<ObjectDataConditionalVec> refPropertiesConditional{};
+		};
+
+		template <ENGINE Engine, class Explain>
+		SwapFormResult GetSwapData(const RefContext& a_context, const RE::BGSMaterialSwap* a_materialSwap, Explain& a_explain);
+
+		template <ENGINE Engine, class Explain>
+		SwapFormResult GetSwapFormConditional(const RefContext& a_context, const RE::BGSMaterialSwap* a_materialSwap, Explain& a_explain);
+		template <ENGINE Engine, class Explain>
+		std::optional<ObjectProperties> GetObjectPropertiesConditional(const RefContext& a_context, const RE::BGSMaterialSwap* a_materialSwap, Explain& a_explain);
+
+		template <ENGINE Engine, class T, class Explain>
+		static const ConditionalData<T>* FindConditional(const ConditionalList<T>& a_list, const ConditionalInput& a_input, Explain& a_explain);
+
 		void LoadForms();
+		void LoadINIs();
+		void ApplyRuleBatch(RuleBatch& a_batch);
+		void AddToFingerprint(std::string_view a_str, std::uint64_t a_value);
+		void ResolveSwapForms();
+		void BuildLeveledListCache();
+		void CompileConditionalLists();
+		void BuildHookCategories();
+
+		// runs on conflictWorker after LoadForms, reads the published rule maps and writes the conflict report
+		void AnalyzeConflicts(std::stop_token a_token);
+
+		// with bLazyRules, loads the indexed keys that can't wait for their first lookup
+		// (keys API batches also use, and projectile/hazard keys BuildHookCategories needs), then hooks up the finalizers
+		// in shadow mode the remaining keys are also parsed now into the reference engine's maps
+		void FinishLazyRules();
+		void AddLazyLeveledLists(const SwapFormDataVec& a_swapDataVec);
+
+		// nullopt if a_list has no valid flattened copy
+		std::optional<RE::TESBoundObject*> PickFlatLeveledList(const RE::TESLevItem* a_list, const RefContext& a_context) const;
+
+		static HOOK_TYPE GetHookType(const RE::TESForm* a_form);
 
 		// members
 		FormIDMap<SwapFormDataVec> swapRefs{};
-		FormIDMap<std::vector<SwapFormDataConditional>> swapFormsConditional{};
+		FormIDMap<SwapFormDataConditionalVec> swapFormsConditional{};
 		FormIDMap<SwapFormDataVec> swapForms{};
 
 		FormIDMap<ObjectDataVec> refProperties{};
-		FormIDMap<std::vector<ObjectDataConditional>> refPropertiesConditional{};
+		FormIDMap<ObjectDataConditionalVec> refPropertiesConditional{};
+
+		WildcardIndex wildcards{};
+
+		LazyRuleMap<SwapFormData> lazySwapRefs{ SwapFormData::GetForms };
+		LazyRuleMap<SwapFormData> lazySwapForms{ SwapFormData::GetForms };
+		LazyRuleMap<ObjectData>   lazyRefProperties{ ObjectData::GetProperties };
+
+		// shadow mode with bLazyRules, the reference engine's eagerly parsed copy of the lazy keys
+		FormIDMap<SwapFormDataVec> referenceSwapRefs{};
+		FormIDMap<SwapFormDataVec> referenceSwapForms{};
+		FormIDMap<ObjectDataVec>   referenceRefProperties{};
+
+		FormIDMap<FlatLeveledList> flatLeveledLists{};
+		// swap targets of lazily loaded rules, flattened when their key is
+		core::ShardedTable<FormIDMap<FlatLeveledList>> lazyLeveledLists{};
+
+		// rule keys per projectile/hazard hook, empty sets turn the hook into a no-op
+		std::array<Set<RE::FormID>, std::to_underlying(HOOK_TYPE::kTotal)> hookKeys{};
+		std::array<bool, std::to_underlying(HOOK_TYPE::kTotal)>            hookWildcards{};  // type(PROJ) or type(HAZD) rules
+
+		// persisted in the co-save, restored refs skip swap evaluation
+		// sharded, every hook call reads these from several loader threads
+		core::ShardedTable<FormIDMap<SwapDecision>> swapDecisions{};
+		core::ShardedTable<Set<RE::FormID>>         swappedLeveledItemRefs{};
+		std::uint64_t                               rulesFingerprint{ 0 };
+
+		std::vector<RuleBatch> pendingBatches{};
+		std::mutex             pendingLock{};
+		bool                   formsLoaded{ false };
 
-		Set<RE::FormID> swappedLeveledItemRefs{};
+		std::atomic<bool>         hasConflicts{ false };
+		std::atomic<bool>         conflictsAnalyzed{ false };
+		mutable std::atomic<bool> conflictsPrinted{ false };
+		std::once_flag            init{};
 
-		bool hasConflicts{ false };
-		std::once_flag init{};
+		// last member, joined before the maps it reads are destroyed
+		std::jthread conflictWorker{};
 	};
 }
@@ -0,0 +1,59 @@
+#pragma once
+
+// heap footprint of the rule maps, estimated from container capacities
+// rule data and the record/path strings kept for logging are counted separately
+// broken down per rule map, per mod and per source file
+class MemoryReport
+{
+public:
+	struct Usage
+	{
+		std::size_t entries{ 0 };
+		std::size_t dataBytes{ 0 };
+		std::size_t stringBytes{ 0 };
+
+		Usage& operator+=(const Usage& a_rhs);
+	};
+
+	template <class T>
+	static std::size_t vector_bytes(const std::vector<T>& a_vec)
+	{
+		return a_vec.capacity() * sizeof(T);
+	}
+
+	static std::size_t string_bytes(const std::string& a_str);
+
+	// ankerl::unordered_dense keeps values in a vector, plus one 8 byte bucket per slot
+	template <class M>
+	static std::size_t table_bytes(const M& a_map)
+	{
+		return a_map.values().capacity() * sizeof(typename M::value_type) + a_map.bucket_count() * 8;
+	}
+
+	void AddTable(std::string_view a_name, std::size_t a_keys, std::size_t a_tableBytes, float a_loadFactor);
+	void AddRule(std::string_view a_name, const std::string& a_path, const Usage& a_usage);
+	void AddShared(std::string_view a_name, const Usage& a_usage);
+
+	void Log() const;
+
+private:
+	struct Table
+	{
+		std::string name{};
+		std::size_t keys{ 0 };
+		std::size_t tableBytes{ 0 };
+		float       loadFactor{ 0.0f };
+		Usage       rules{};
+	};
+
+	Table& get_table(std::string_view a_name);
+
+	// the loaded plugin an INI is named after ("Mod_SWAP.ini", "Mod_Extra_SWAP.ini" -> Mod.esp), or its name without the suffix
+	// a_plugins : lowercase name -> name
+	static std::string get_owner(std::string_view a_path, const Map<std::string, std::string>& a_plugins);
+
+	// members
+	std::vector<Table>                         tables{};
+	Map<std::string, Usage>                    paths{};
+	std::vector<std::pair<std::string, Usage>> shared{};
+};
@@ -4,7 +4,7 @@
 
 struct RandValueParams
 {
-	RandValueParams(CHANCE_TYPE a_type, const RE::TESObjectREFR* a_ref);
+	RandValueParams(CHANCE_TYPE a_type, const RefContext& a_context);
 
 	BOS_RNG rng{};
 	bool    clamp{ false };
@@ -37,6 +37,8 @@ public:
 	ScaleRange() = default;
 	ScaleRange(const std::string& a_str);
 
+	bool operator==(const ScaleRange&) const = default;
+
 	void SetScale(RE::TESObjectREFR* a_ref, const RandValueParams& a_params) const;
 
 	// members
@@ -50,6 +52,8 @@ public:
 	Point3Range() = default;
 	Point3Range(const std::string& a_str, bool a_convertToRad = false);
 
+	bool operator==(const Point3Range&) const = default;
+
 	RE::NiPoint3 min() const;
 	RE::NiPoint3 max() const;
 	bool         is_exact() const;
@@ -69,13 +73,20 @@ class ObjectProperties
 public:
 	ObjectProperties() = default;
 	explicit ObjectProperties(const std::string& a_str);
+	ObjectProperties(std::optional<Point3Range> a_location, std::optional<Point3Range> a_rotation, std::optional<ScaleRange> a_refScale, std::uint32_t a_flagsSet, std::uint32_t a_flagsUnset);
+
+	bool operator==(const ObjectProperties&) const = default;
 
 	bool IsValid() const;
 
 	void SetChanceType(CHANCE_TYPE a_type);
-	void SetTransform(RE::TESObjectREFR* a_refr) const;
+	void SetTransform(const RefContext& a_context) const;
 	void SetRecordFlags(RE::TESObjectREFR* a_refr) const;
 
+	// co-save, properties of a restored swap decision
+	void Save(std::vector<std::uint8_t>& a_buf) const;
+	bool Load(std::span<const std::uint8_t> a_buf, std::size_t& a_pos);
+
 private:
 	void assign_record_flags(const std::string& a_str, bool a_unsetFlag);
 
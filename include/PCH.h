@@ -10,6 +10,7 @@
 #include "F4SE/F4SE.h"
 #include "RE/Fallout.h"
 
+#include <spdlog/async.h>
 #ifdef NDEBUG
 #	include <spdlog/sinks/basic_file_sink.h>
 #else
@@ -23,6 +24,7 @@
 #include <CLibUtil/string.hpp>
 #include <CLibUtil/singleton.hpp>
 #include <ankerl/unordered_dense.h>
+#include <mmio/mmio.hpp>
 #include <srell.hpp>
 #pragma warning(pop)
 
@@ -42,8 +44,6 @@ struct overload : Ts...
 	using Ts::operator()...;
 };
 
-using FormIDStr = std::variant<RE::FormID, std::string>;
-
 template <class K, class D>
 using Map = ankerl::unordered_dense::map<K, D>;
 template <class T>
@@ -1,5 +1,9 @@
 #pragma once
 
+#include "SwapExplain.h"
+
+class RefContext;
+
 struct BOS_RNG
 {
 public:
@@ -11,7 +15,7 @@ public:
 	};
 
 	BOS_RNG() = default;
-	BOS_RNG(CHANCE_TYPE a_type, const RE::TESObjectREFR* a_ref);
+	BOS_RNG(CHANCE_TYPE a_type, const RefContext& a_context);
 
 	template <class T>
 	T generate(T a_min, T a_max) const
@@ -23,8 +27,8 @@ public:
 	}
 
 	// members
-	CHANCE_TYPE   type;
-	std::uint64_t seed;
+	CHANCE_TYPE   type{ CHANCE_TYPE::kRandom };
+	std::uint64_t seed{ 0 };
 };
 
 using CHANCE_TYPE = BOS_RNG::CHANCE_TYPE;
@@ -34,8 +38,31 @@ struct Chance
 public:
 	Chance() = default;
 	explicit Chance(const std::string& a_str);
+	Chance(CHANCE_TYPE a_type, float a_value);
+
+	bool PassedChance(const RefContext& a_context) const;
+
+	template <class Explain>
+	bool PassedChance(const RefContext& a_context, Explain& a_explain) const
+	{
+		if (chanceValue >= 100.0f) {
+			return true;
+		}
+
+		const BOS_RNG rng(chanceType, a_context);
+		const auto    rngValue = rng.generate<float>(0.0f, 100.0f);
+		const bool    passed = rngValue <= chanceValue;
 
-	bool PassedChance(const RE::TESObjectREFR* a_ref) const;
+		if constexpr (Explain::enabled) {
+			constexpr std::array typeNames{ "random"sv, "ref hash"sv, "location hash"sv };
+			a_explain.Log("chance {}% ({}) : seed {}, rolled {:.2f}, {}",
+				chanceValue, typeNames[std::to_underlying(chanceType)],
+				chanceType == CHANCE_TYPE::kRandom ? "none"s : std::to_string(rng.seed),
+				rngValue, passed ? "passed" : "failed");
+		}
+
+		return passed;
+	}
 
 	// members
 	CHANCE_TYPE chanceType{ CHANCE_TYPE::kRefHash };
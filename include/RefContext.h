@@ -0,0 +1,76 @@
+#pragma once
+
+#include "CellDataCache.h"
+#include "Core/ResultBits.h"
+
+// engine queries for the ref being swapped, made lazily and at most once
+// shared by the swap, property and chance stages
+class RefContext
+{
+public:
+	RefContext(RE::TESObjectREFR* a_ref, const RE::TESForm* a_base);
+	~RefContext();
+
+	RefContext(const RefContext&) = delete;
+	RefContext& operator=(const RefContext&) = delete;
+
+	[[nodiscard]] RE::TESObjectREFR*  GetRef() const { return ref; }
+	[[nodiscard]] const RE::TESForm*  GetBase() const { return base; }
+	[[nodiscard]] RE::FormID          GetRefID() const { return refID; }
+
+	[[nodiscard]] bool                              IsCreated() const;
+	[[nodiscard]] RE::TESObjectCELL*                GetCell() const;
+	[[nodiscard]] RE::BGSLocation*                  GetLocation() const;
+	[[nodiscard]] const CellData&                   GetCellData() const;
+	[[nodiscard]] const std::vector<std::uint32_t>& GetSpatialMatches() const;
+
+	// location or cell formID, 0 if the ref has neither
+	[[nodiscard]] RE::FormID GetLocationSeedID() const;
+
+	// random rolls (random chance, engine leveled list picks) made for this ref, shadow mode doesn't compare results that depend on them
+	void                        MarkNondeterministic() const { nondeterministic++; }
+	[[nodiscard]] std::uint32_t GetNondeterministicCount() const { return nondeterministic; }
+
+	// result of a shared condition filter set, evaluated once per ref
+	template <class F>
+	bool GetFilterSetResult(std::uint32_t a_filterSetID, F&& a_evaluate) const
+	{
+		return filterSetResults.Get(a_filterSetID, std::forward<F>(a_evaluate));
+	}
+
+	static void LogStats();
+
+private:
+	template <class T, class F>
+	const T& get(std::optional<T>& a_cache, F&& a_query) const
+	{
+		requested++;
+		if (!a_cache) {
+			performed++;
+			a_cache.emplace(a_query());
+		}
+		return *a_cache;
+	}
+
+	// members
+	RE::TESObjectREFR* ref;
+	const RE::TESForm* base;
+	RE::FormID         refID;
+
+	mutable std::optional<bool>                       isCreated{};
+	mutable std::optional<RE::TESObjectCELL*>         cell{};
+	mutable std::optional<RE::BGSLocation*>           location{};
+	mutable CellDataCache::Ptr                        cellData{};  // kept alive across a cache reset
+	mutable std::optional<std::vector<std::uint32_t>> spatialMatches{};
+
+	mutable core::ResultBits<256> filterSetResults{};
+
+	mutable std::uint32_t nondeterministic{ 0 };
+	mutable std::uint32_t requested{ 0 };
+	mutable std::uint32_t performed{ 0 };
+
+	// totals since the last LogStats
+	static inline std::atomic<std::uint64_t> totalRefs{ 0 };
+	static inline std::atomic<std::uint64_t> totalRequested{ 0 };
+	static inline std::atomic<std::uint64_t> totalPerformed{ 0 };
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+namespace Serialization
+{
+	enum : std::uint32_t
+	{
+		kSerializationVersion = 1,
+
+		kBOS = 'BOSF',
+		kSwapDecisions = 'SWAP',
+		kLeveledItemRefs = 'LVLR'
+	};
+
+	// formID lists are sorted, delta encoded and stored as LEB128 varints
+	void WriteVarint(std::vector<std::uint8_t>& a_buf, std::uint32_t a_value);
+	bool ReadVarint(std::span<const std::uint8_t> a_buf, std::size_t& a_pos, std::uint32_t& a_value);
+
+	// trivially copyable values, stored as is
+	template <class T>
+	void WriteFixed(std::vector<std::uint8_t>& a_buf, const T& a_value)
+	{
+		const auto pos = a_buf.size();
+		a_buf.resize(pos + sizeof(T));
+		std::memcpy(a_buf.data() + pos, std::addressof(a_value), sizeof(T));
+	}
+
+	template <class T>
+	bool ReadFixed(std::span<const std::uint8_t> a_buf, std::size_t& a_pos, T& a_value)
+	{
+		if (a_pos + sizeof(T) > a_buf.size()) {
+			return false;
+		}
+		std::memcpy(std::addressof(a_value), a_buf.data() + a_pos, sizeof(T));
+		a_pos += sizeof(T);
+		return true;
+	}
+
+	void SaveCallback(const F4SE::SerializationInterface* a_intfc);
+	void LoadCallback(const F4SE::SerializationInterface* a_intfc);
+	void RevertCallback(const F4SE::SerializationInterface* a_intfc);
+}
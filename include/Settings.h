@@ -0,0 +1,15 @@
+#pragma once
+
+// Data\F4SE\Plugins\po3_BaseObjectSwapperF4.ini
+class Settings : public ISingleton<Settings>
+{
+public:
+	void Load();
+
+	// members
+	bool  lazyRules{ false };  // [Forms], [References] and [Properties] lines are parsed per key on first lookup
+	bool  recordTrace{ false };
+	bool  profileFilters{ false };
+	bool  profileLoad{ false };  // parser stage throughput in the PROFILE section
+	float shadowSampleRate{ 0.0f };  // fraction of refs evaluated by both rule engines
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "RefContext.h"
+#include "SwapData.h"
+
+// runs a sampled fraction of swap_base lookups through both rule engines and compares the winning base and properties
+// the compiled result is always the one returned, divergences are logged with an explain trace of both engines
+// results that depend on random rolls are timed but not compared
+// refs with a swap decision return it before sampling, neither engine runs for them
+//
+// Data\F4SE\Plugins\po3_BaseObjectSwapperF4.ini
+// [Debug]
+// fShadowSampleRate = 0.05
+class ShadowEval : public ISingleton<ShadowEval>
+{
+public:
+	void Start();
+
+	[[nodiscard]] bool IsEnabled() const { return threshold != 0; }
+
+	// sampling is by refID, so a sampled ref is sampled on every load
+	[[nodiscard]] bool ShouldSample(RE::FormID a_refID) const
+	{
+		return threshold != 0 && ((static_cast<std::uint64_t>(a_refID) * 0x9E3779B97F4A7C15ull) >> 32) < threshold;
+	}
+
+	// a_compiled and a_reference return FormSwap::SwapFormResult, a_explain logs both engines for a divergence
+	template <class Compiled, class Reference, class Explain>
+	FormSwap::SwapFormResult Compare(const RefContext& a_context, Compiled&& a_compiled, Reference&& a_reference, Explain&& a_explain)
+	{
+		const auto rolls = a_context.GetNondeterministicCount();
+
+		auto start = std::chrono::steady_clock::now();
+		auto compiled = a_compiled();
+		compiledTime.fetch_add(elapsed(start), std::memory_order_relaxed);
+
+		start = std::chrono::steady_clock::now();
+		const auto reference = a_reference();
+		referenceTime.fetch_add(elapsed(start), std::memory_order_relaxed);
+
+		samples.fetch_add(1, std::memory_order_relaxed);
+
+		if (a_context.GetNondeterministicCount() != rolls) {
+			nondeterministic.fetch_add(1, std::memory_order_relaxed);
+		} else if (compiled == reference) {
+			matches.fetch_add(1, std::memory_order_relaxed);
+		} else if (divergences.fetch_add(1, std::memory_order_relaxed) < maxLogged) {
+			log_divergence(a_context, compiled, reference);
+			a_explain();
+		}
+
+		return compiled;
+	}
+
+	void LogStats();
+
+private:
+	static std::uint64_t elapsed(std::chrono::steady_clock::time_point a_start)
+	{
+		return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - a_start).count());
+	}
+
+	static void log_divergence(const RefContext& a_context, const FormSwap::SwapFormResult& a_compiled, const FormSwap::SwapFormResult& a_reference);
+
+	static constexpr std::uint64_t maxLogged{ 20 };
+
+	// members
+	std::uint64_t              threshold{ 0 };  // of 2^32
+	std::atomic<std::uint64_t> samples{ 0 };
+	std::atomic<std::uint64_t> matches{ 0 };
+	std::atomic<std::uint64_t> divergences{ 0 };
+	std::atomic<std::uint64_t> nondeterministic{ 0 };
+	std::atomic<std::uint64_t> compiledTime{ 0 };
+	std::atomic<std::uint64_t> referenceTime{ 0 };
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+// spatial filter, index into SpatialIndex regions
+struct SpatialID
+{
+	bool operator==(const SpatialID&) const = default;
+
+	// members
+	std::uint32_t value{ 0 };
+};
+
+// [Forms|radius(Worldspace, x, y, r)]                          2D distance
+// [Forms|radius(Worldspace, x, y, z, r)]                       3D distance
+// [Forms|box(Worldspace, minX, minY, minZ, maxX, maxY, maxZ)]
+// [Forms|cells(Worldspace, minCellX, minCellY, maxCellX, maxCellY)]
+//
+// regions are bucketed into a uniform grid per worldspace, so a ref only tests the regions overlapping its grid cell
+class SpatialIndex : public ISingleton<SpatialIndex>
+{
+public:
+	static bool IsSpatialFilter(const std::string& a_str);
+
+	std::optional<SpatialID> Parse(const std::string& a_str);
+	void                     Build();
+
+	// sorted IDs of every region containing a_pos
+	void GetMatches(const RE::TESWorldSpace* a_worldspace, const RE::NiPoint3& a_pos, std::vector<std::uint32_t>& a_matches) const;
+
+	[[nodiscard]] bool empty() const;
+
+	// filter string the region was parsed from, load time only
+	[[nodiscard]] std::string GetSource(SpatialID a_spatialID) const;
+
+	[[nodiscard]] RE::FormID GetWorldspace(SpatialID a_spatialID) const;
+
+private:
+	struct Region
+	{
+		enum class TYPE
+		{
+			kRadius2D,
+			kRadius3D,
+			kBox
+		};
+
+		[[nodiscard]] bool Contains(const RE::NiPoint3& a_pos) const;
+
+		// members
+		RE::FormID   worldspace{ 0 };
+		TYPE         type{ TYPE::kBox };
+		RE::NiPoint3 min{};
+		RE::NiPoint3 max{};
+		RE::NiPoint3 center{};
+		float        radiusSquared{ 0.0f };
+	};
+
+	struct WorldspaceGrid
+	{
+		Map<std::uint64_t, std::vector<std::uint32_t>> buckets{};
+		std::vector<std::uint32_t>                     largeRegions{};  // span too many buckets, always tested
+	};
+
+	static constexpr float         bucketSize{ 4096.0f };  // exterior cell
+	static constexpr std::uint32_t maxBucketsPerRegion{ 256 };
+
+	static std::int32_t  to_bucket(float a_coord);
+	static std::uint64_t bucket_key(std::int32_t a_x, std::int32_t a_y);
+
+	// members
+	std::vector<Region>              regions{};
+	Map<std::string, std::uint32_t>  regionIDs{};  // identical filters share one region
+	FormIDMap<WorldspaceGrid>        grids{};
+};
@@ -18,8 +18,16 @@ namespace FormSwap
 
 		ObjectData() = delete;
 		explicit ObjectData(const Input& a_input);
+		ObjectData(const ObjectProperties& a_properties, const Chance& a_chance, std::string a_record, std::string a_path);
+
+		bool HasValidProperties(const RefContext& a_context) const;
+
+		template <class Explain>
+		bool HasValidProperties(const RefContext& a_context, Explain& a_explain) const
+		{
+			return chance.PassedChance(a_context, a_explain) && properties.IsValid();
+		}
 
-		bool        HasValidProperties(const RE::TESObjectREFR* a_ref) const;
 		static void GetProperties(const std::string& a_path, const std::string& a_str, std::function<void(RE::FormID, ObjectData&)> a_func);
 
 		// members
@@ -36,19 +44,59 @@ namespace FormSwap
 	public:
 		SwapFormData() = delete;
 		SwapFormData(FormIDOrSet a_id, const Input& a_input);
+		SwapFormData(FormIDOrSet a_id, const ObjectData& a_objectData);
+
+		RE::TESBoundObject* GetSwapBase(const RefContext& a_context) const;
+
+		template <class Explain>
+		RE::TESBoundObject* GetSwapBase(const RefContext& a_context, Explain& a_explain) const
+		{
+			if (!chance.PassedChance(a_context, a_explain)) {
+				return nullptr;
+			}
+
+			if (swapObjects.size() < 2) {
+				return swapObjects.empty() ? nullptr : swapObjects.front();
+			}
+
+			// return random element from set
+			const BOS_RNG rng(chance.chanceType, a_context);
+			const auto    setEnd = static_cast<std::int64_t>(swapObjects.size()) - 1;
+			const auto    randIt = rng.generate<std::int64_t>(0, setEnd);
+
+			if constexpr (Explain::enabled) {
+				a_explain.Log("picked {} of {} swap forms : seed {}", randIt + 1, swapObjects.size(), chance.chanceType == CHANCE_TYPE::kRandom ? "none"s : std::to_string(rng.seed));
+			}
+
+			return swapObjects[randIt];
+		}
 
-		RE::TESBoundObject* GetSwapBase(const RE::TESObjectREFR* a_ref) const;
 		static void         GetForms(const std::string& a_path, const std::string& a_str, std::function<void(RE::FormID, SwapFormData&)> a_func);
 
+		// looks up formIDSet once after data load, dropping deleted and non-bound forms
+		// returns false if no swap form is left
+		bool ResolveSwapObjects();
+
 		// members
-		FormIDOrSet formIDSet{};
+		FormIDOrSet                      formIDSet{};
+		std::vector<RE::TESBoundObject*> swapObjects{};
 	};
 
 	using ObjectDataVec = std::vector<ObjectData>;
 	using ObjectDataConditional = ConditionalData<ObjectData>;
+	using ObjectDataConditionalVec = ConditionalList<ObjectData>;
 
 	using SwapFormDataVec = std::vector<SwapFormData>;
 	using SwapFormDataConditional = ConditionalData<SwapFormData>;
+	using SwapFormDataConditionalVec = ConditionalList<SwapFormData>;
 
 	using SwapFormResult = std::pair<RE::TESBoundObject*, std::optional<ObjectProperties>>;
+
+	// swap applied to a persistent ref, reapplied on later loads while the ref keeps its original base
+	struct SwapDecision
+	{
+		RE::FormID                      baseID{ 0 };  // base before the swap
+		RE::TESBoundObject*             swapBase{ nullptr };
+		std::optional<ObjectProperties> properties{};  // of the winning rule, re-rolled from the same seed
+	};
 }
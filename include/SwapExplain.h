@@ -0,0 +1,60 @@
+#pragma once
+
+// tracers for the swap pipeline, passed down as a template parameter
+// the hooks use NoExplain, every call on it compiles to nothing
+struct NoExplain
+{
+	static constexpr bool enabled{ false };
+
+	struct Stage
+	{};
+
+	Stage BeginStage(std::string_view) { return {}; }
+};
+
+// one line per step, with the time spent in each stage
+// filled by Manager::ExplainSwapData for the console command, and by shadow mode for divergences
+class SwapExplain
+{
+public:
+	static constexpr bool enabled{ true };
+
+	class Stage
+	{
+	public:
+		Stage(SwapExplain& a_explain, std::size_t a_line);
+		~Stage();
+
+		Stage(const Stage&) = delete;
+		Stage& operator=(const Stage&) = delete;
+
+	private:
+		// members
+		SwapExplain&                          explain;
+		std::size_t                           line;
+		std::chrono::steady_clock::time_point start;
+	};
+
+	[[nodiscard]] Stage BeginStage(std::string_view a_name);
+
+	template <class... Args>
+	void Log(std::format_string<Args...> a_fmt, Args&&... a_args)
+	{
+		lines.push_back({ depth, std::format(a_fmt, std::forward<Args>(a_args)...), std::nullopt });
+	}
+
+	// log, and the console if a_console (main thread only)
+	void Print(bool a_console = true) const;
+
+private:
+	struct Line
+	{
+		std::uint32_t                depth{ 0 };
+		std::string                  text{};
+		std::optional<std::uint64_t> nanoseconds{};
+	};
+
+	// members
+	std::vector<Line> lines{};
+	std::uint32_t     depth{ 0 };
+};
@@ -0,0 +1,140 @@
+#pragma once
+
+// Binary trace of swap_base inputs, written by TraceRecorder and read by tools/TraceReplay.
+// This header is self-contained so host tools can include it without the game headers.
+//
+// file   : FileHeader, then records until EOF
+// record : fixed fields, then four formID lists, each a LEB128 varint count followed by the formIDs as varints
+
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+
+namespace BOSTrace
+{
+	using FormID = std::uint32_t;
+
+	inline constexpr std::uint32_t MAGIC = 0x54534F42;  // "BOST"
+	inline constexpr std::uint32_t VERSION = 1;
+
+	struct FileHeader
+	{
+		std::uint32_t magic{ MAGIC };
+		std::uint32_t version{ VERSION };
+	};
+
+	struct Record
+	{
+		enum Flags : std::uint8_t
+		{
+			kNone = 0,
+			kCreated = 1 << 0,   // ref->IsCreated(), skips reference swaps
+			kRestored = 1 << 1,  // swap decision restored from the co-save, rules were not evaluated
+		};
+
+		FormID       ref{ 0 };
+		FormID       base{ 0 };
+		FormID       materialSwap{ 0 };
+		FormID       cell{ 0 };
+		FormID       worldspace{ 0 };  // 0 for interiors
+		float        position[3]{};
+		FormID       result{ 0 };  // swapped base, 0 if not swapped
+		std::uint8_t flags{ kNone };
+
+		std::vector<FormID> locations{};         // current location, then its parents
+		std::vector<FormID> regions{};           // regions of the cell, sorted
+		std::vector<FormID> locationKeywords{};  // keywords of the current location
+		std::vector<FormID> refKeywords{};       // keywords of the base
+	};
+
+	inline void WriteVarint(std::vector<std::uint8_t>& a_buf, std::uint32_t a_value)
+	{
+		while (a_value >= 0x80) {
+			a_buf.push_back(static_cast<std::uint8_t>(a_value | 0x80));
+			a_value >>= 7;
+		}
+		a_buf.push_back(static_cast<std::uint8_t>(a_value));
+	}
+
+	inline bool ReadVarint(std::span<const std::uint8_t> a_buf, std::size_t& a_pos, std::uint32_t& a_value)
+	{
+		a_value = 0;
+		for (std::uint32_t shift = 0; shift < 35 && a_pos < a_buf.size(); shift += 7) {
+			const auto byte = a_buf[a_pos++];
+			a_value |= static_cast<std::uint32_t>(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	inline void WriteRecord(std::vector<std::uint8_t>& a_buf, const Record& a_record)
+	{
+		const auto write_fixed = [&](const auto& a_value) {
+			const auto pos = a_buf.size();
+			a_buf.resize(pos + sizeof(a_value));
+			std::memcpy(a_buf.data() + pos, &a_value, sizeof(a_value));
+		};
+		const auto write_list = [&](const std::vector<FormID>& a_list) {
+			WriteVarint(a_buf, static_cast<std::uint32_t>(a_list.size()));
+			for (const auto formID : a_list) {
+				WriteVarint(a_buf, formID);
+			}
+		};
+
+		write_fixed(a_record.ref);
+		write_fixed(a_record.base);
+		write_fixed(a_record.materialSwap);
+		write_fixed(a_record.cell);
+		write_fixed(a_record.worldspace);
+		write_fixed(a_record.position);
+		write_fixed(a_record.result);
+		write_fixed(a_record.flags);
+
+		write_list(a_record.locations);
+		write_list(a_record.regions);
+		write_list(a_record.locationKeywords);
+		write_list(a_record.refKeywords);
+	}
+
+	// returns false on a truncated or malformed record
+	inline bool ReadRecord(std::span<const std::uint8_t> a_buf, std::size_t& a_pos, Record& a_record)
+	{
+		const auto read_fixed = [&](auto& a_value) {
+			if (a_pos + sizeof(a_value) > a_buf.size()) {
+				return false;
+			}
+			std::memcpy(&a_value, a_buf.data() + a_pos, sizeof(a_value));
+			a_pos += sizeof(a_value);
+			return true;
+		};
+		const auto read_list = [&](std::vector<FormID>& a_list) {
+			std::uint32_t count = 0;
+			if (!ReadVarint(a_buf, a_pos, count) || count > a_buf.size() - a_pos) {
+				return false;
+			}
+			a_list.resize(count);
+			for (auto& formID : a_list) {
+				if (!ReadVarint(a_buf, a_pos, formID)) {
+					return false;
+				}
+			}
+			return true;
+		};
+
+		return read_fixed(a_record.ref) &&
+		       read_fixed(a_record.base) &&
+		       read_fixed(a_record.materialSwap) &&
+		       read_fixed(a_record.cell) &&
+		       read_fixed(a_record.worldspace) &&
+		       read_fixed(a_record.position) &&
+		       read_fixed(a_record.result) &&
+		       read_fixed(a_record.flags) &&
+		       read_list(a_record.locations) &&
+		       read_list(a_record.regions) &&
+		       read_list(a_record.locationKeywords) &&
+		       read_list(a_record.refKeywords);
+	}
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "TraceFormat.h"
+
+class RefContext;
+
+// records every swap_base input to <log directory>\po3_BaseObjectSwapperF4.trace, for tools/TraceReplay
+// enabled with bRecordTrace in the settings INI, free otherwise
+// flushed every 1 MB and before or after each save and load, records made after the last flush are lost on exit
+class TraceRecorder : public ISingleton<TraceRecorder>
+{
+public:
+	void Open();
+	void Flush();
+
+	[[nodiscard]] bool IsRecording() const { return recording; }
+
+	void Record(const RefContext& a_context, const RE::BGSMaterialSwap* a_materialSwap, const RE::TESBoundObject* a_result, bool a_restored);
+
+private:
+	static constexpr std::size_t flushSize{ 1 << 20 };
+
+	void flush_impl();
+
+	// members
+	bool                      recording{ false };
+	std::mutex                lock{};
+	std::ofstream             file{};
+	std::vector<std::uint8_t> buffer{};
+	std::size_t               records{ 0 };
+};
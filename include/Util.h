@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Core/RuleParser.h"
+
 namespace regex
 {
 	inline srell::regex generic{ R"(\((.*?)\))" };                // pos(0,0,100) -> "0,0,100"
@@ -11,6 +13,16 @@ namespace util
 {
 	std::vector<std::string> split_with_regex(const std::string& a_str, const srell::regex& a_regex);
 
+	// core parsers resolve through the loaded data, parse errors go to LoadErrors
+	class GameFormLookup final : public core::FormLookup
+	{
+	public:
+		RE::FormID LookupFormID(RE::FormID a_localID, std::string_view a_plugin) const override;
+		RE::FormID LookupEditorID(std::string_view a_editorID) const override;
+		bool       IsLoaded(RE::FormID a_formID) const override;
+		void       Report(core::ParseError a_error, std::string_view a_entry) const override;
+	};
+
 	RE::FormID  GetFormID(const std::string& a_str);
-	FormIDOrSet GetSwapFormID(const std::string& a_str);
+	FormIDOrSet GetSwapFormID(const core::RuleLine& a_line);
 }
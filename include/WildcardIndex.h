@@ -0,0 +1,143 @@
+#pragma once
+
+#include "SwapData.h"
+
+namespace FormSwap
+{
+	// [Forms] rules keyed by keyword or form type instead of a base
+	// keyword(EditorID or 0xID~Plugin)|swapForm|properties|chance
+	// type(STAT)|swapForm|properties|chance
+	//
+	// consulted after exact form swaps, so any rule keyed on the base itself wins
+	// among wildcard rules the one loaded last wins, keyword and type rules alike
+	class WildcardIndex
+	{
+	public:
+		static bool IsWildcard(std::string_view a_key);
+
+		void Add(const std::string& a_path, const std::string& a_str);
+
+		// drops rules without valid swap forms, returns how many were dropped
+		std::size_t ResolveSwapObjects();
+
+		template <class F>
+		void ForEachRule(F&& a_func) const
+		{
+			for (const auto* map : { &keywords, &formTypes }) {
+				for (const auto& rules : *map | std::views::values) {
+					for (const auto& rule : rules) {
+						a_func(rule.data);
+					}
+				}
+			}
+		}
+
+		[[nodiscard]] bool        HasFormType(RE::ENUM_FORM_ID a_formType) const { return formTypes.contains(std::to_underlying(a_formType)); }
+		[[nodiscard]] bool        empty() const { return keywords.empty() && formTypes.empty(); }
+		[[nodiscard]] std::size_t size() const;
+
+		template <class Explain>
+		SwapFormResult GetSwapBase(const RE::TESForm* a_base, const RefContext& a_context, Explain& a_explain) const
+		{
+			if (empty()) {
+				return { nullptr, std::nullopt };
+			}
+
+			// one pass over the base's keywords, most miss the 64 bit filter without a hash lookup
+			// matching buckets are kept as spans in a fixed buffer, only bases with more than
+			// maxBuckets matching keywords spill to the heap
+			std::array<std::span<const Rule>, maxBuckets> fixedBuckets{};
+			std::vector<std::span<const Rule>>            spilledBuckets{};
+			std::size_t                                   bucketCount = 0;
+
+			const auto get_buckets = [&]() -> std::span<std::span<const Rule>> {
+				return bucketCount <= maxBuckets ? std::span(fixedBuckets).first(bucketCount) : std::span(spilledBuckets);
+			};
+			const auto add_rules = [&](const std::vector<Rule>& a_rules) {
+				// a keyword listed twice on the base points at the same bucket
+				if (std::ranges::any_of(get_buckets(), [&](const auto& a_bucket) { return a_bucket.data() == a_rules.data(); })) {
+					return;
+				}
+				if (bucketCount < maxBuckets) {
+					fixedBuckets[bucketCount] = a_rules;
+				} else {
+					if (spilledBuckets.empty()) {
+						spilledBuckets.assign(fixedBuckets.begin(), fixedBuckets.end());
+					}
+					spilledBuckets.emplace_back(a_rules);
+				}
+				bucketCount++;
+			};
+
+			if (keywordFilter != 0) {
+				if (const auto keywordForm = a_base->As<RE::BGSKeywordForm>()) {
+					for (std::uint32_t i = 0; i < keywordForm->numKeywords; ++i) {
+						const auto keyword = keywordForm->keywords[i];
+						if (!keyword || (keywordFilter & filter_bit(keyword->GetFormID())) == 0) {
+							continue;
+						}
+						if (const auto it = keywords.find(keyword->GetFormID()); it != keywords.end()) {
+							add_rules(it->second);
+						}
+					}
+				}
+			}
+
+			if (const auto it = formTypes.find(std::to_underlying(a_base->GetFormType())); it != formTypes.end()) {
+				add_rules(it->second);
+			}
+
+			if (bucketCount == 0) {
+				return { nullptr, std::nullopt };
+			}
+
+			// each bucket is in load order already, merge them from the back so the last loaded rule is tried first
+			const auto buckets = get_buckets();
+			const auto pop_last = [&]() -> const Rule* {
+				std::span<const Rule>* last = nullptr;
+				for (auto& bucket : buckets) {
+					if (!bucket.empty() && (!last || bucket.back().order > last->back().order)) {
+						last = std::addressof(bucket);
+					}
+				}
+				if (!last) {
+					return nullptr;
+				}
+				const auto rule = std::addressof(last->back());
+				*last = last->first(last->size() - 1);
+				return rule;
+			};
+
+			while (const auto rule = pop_last()) {
+				if (const auto swapObject = rule->data.GetSwapBase(a_context, a_explain)) {
+					if constexpr (Explain::enabled) {
+						a_explain.Log("winner {} ({})", rule->data.record, rule->data.path);
+					}
+					return { swapObject, rule->data.properties };
+				}
+			}
+
+			return { nullptr, std::nullopt };
+		}
+
+	private:
+		struct Rule
+		{
+			std::uint32_t order{ 0 };
+			SwapFormData  data;
+		};
+
+		static constexpr std::size_t maxBuckets{ 16 };  // matching keyword buckets plus the form type bucket
+
+		static std::uint64_t filter_bit(RE::FormID a_formID)
+		{
+			return std::uint64_t(1) << ((a_formID * 0x9E3779B1u) >> 26);
+		}
+
+		// members
+		FormIDMap<std::vector<Rule>>          keywords{};
+		Map<std::uint32_t, std::vector<Rule>> formTypes{};
+		std::uint64_t                         keywordFilter{ 0 };
+		std::uint32_t                         nextOrder{ 0 };  // load order, later rules win
+	};
+}
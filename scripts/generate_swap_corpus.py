@@ -0,0 +1,132 @@
+import argparse
+import os
+import random
+
+# synthetic _SWAP.ini corpus for profiling the config parsers
+# drop the output folder into Data, set bProfileLoad under [Debug] in po3_BaseObjectSwapperF4.ini and check the PROFILE section of the log
+
+KEYWORDS = ["LocTypeSettlement", "LocTypeDungeon", "LocTypeClearable", "LocTypeVault", "LocTypeCity", "LocSetIndustrial", "LocSetMilitary", "LocEncRaiders"]
+FLAGS = ["0x800", "0x10000", "0x400000", "0x2000000"]
+
+def form(a_args, a_rng):
+	if a_args.forms:
+		return a_rng.choice(a_args.forms)
+	return "0x{:X}~{}".format(a_rng.randrange(0x800, 0xFFFFFF), a_args.plugin)
+
+def swap_forms(a_args, a_rng):
+	if a_rng.random() < 0.25:
+		return ",".join(form(a_args, a_rng) for _ in range(a_rng.randint(2, 8)))
+	return form(a_args, a_rng)
+
+def float_range(a_rng, a_min, a_max):
+	if a_rng.random() < 0.5:
+		return "{}".format(a_rng.randint(a_min, a_max))
+	low = a_rng.randint(a_min, a_max)
+	return "{}/{}".format(low, a_rng.randint(low, a_max))
+
+def point3(a_rng, a_name, a_min, a_max):
+	values = ",".join(float_range(a_rng, a_min, a_max) for _ in range(3))
+	return "{}{}({})".format(a_name, "R" if a_rng.random() < 0.5 else "A", values)
+
+def properties(a_rng):
+	props = []
+	if a_rng.random() < 0.3:
+		props.append(point3(a_rng, "pos", -50, 50))
+	if a_rng.random() < 0.3:
+		props.append(point3(a_rng, "rot", -180, 180))
+	if a_rng.random() < 0.2:
+		props.append("scale{}({})".format("A" if a_rng.random() < 0.5 else "", float_range(a_rng, 1, 3)))
+	if a_rng.random() < 0.1:
+		props.append("flags{}({})".format("C" if a_rng.random() < 0.5 else "", ",".join(a_rng.sample(FLAGS, 2))))
+	return ", ".join(props) if props else "NONE"
+
+def chance(a_rng):
+	if a_rng.random() < 0.4:
+		return "chance{}({})".format(a_rng.choice(["", "R", "L"]), a_rng.randint(1, 99))
+	return "NONE"
+
+def swap_entry(a_args, a_rng):
+	entry = "{}|{}".format(form(a_args, a_rng), swap_forms(a_args, a_rng))
+	props = properties(a_rng)
+	odds = chance(a_rng)
+	if odds != "NONE":
+		return "{}|{}|{}".format(entry, props, odds)
+	if props != "NONE":
+		return "{}|{}".format(entry, props)
+	return entry
+
+def property_entry(a_args, a_rng):
+	props = properties(a_rng)
+	if props == "NONE":
+		props = point3(a_rng, "rot", -180, 180)
+	odds = chance(a_rng)
+	return "{}|{}{}".format(form(a_args, a_rng), props, "|" + odds if odds != "NONE" else "")
+
+def conditions(a_args, a_rng):
+	conds = []
+	for _ in range(a_rng.randint(1, 4)):
+		cond = a_rng.choice(KEYWORDS) if a_rng.random() < 0.7 else form(a_args, a_rng)
+		conds.append("-" + cond if a_rng.random() < 0.2 else cond)
+	return ",".join(conds)
+
+def make_ini(a_args, a_rng):
+	lines = []
+	remaining = a_args.entries
+	while remaining > 0:
+		count = min(remaining, a_rng.randint(10, 200))
+		remaining -= count
+
+		roll = a_rng.random()
+		if roll < 0.45:
+			lines.append("[Forms]")
+			lines.extend(swap_entry(a_args, a_rng) for _ in range(count))
+		elif roll < 0.70:
+			lines.append("[Forms|{}]".format(conditions(a_args, a_rng)))
+			lines.extend(swap_entry(a_args, a_rng) for _ in range(count))
+		elif roll < 0.80:
+			lines.append("[References]")
+			lines.extend(swap_entry(a_args, a_rng) for _ in range(count))
+		elif roll < 0.92:
+			lines.append("[Properties]")
+			lines.extend(property_entry(a_args, a_rng) for _ in range(count))
+		else:
+			lines.append("[Properties|{}]".format(conditions(a_args, a_rng)))
+			lines.extend(property_entry(a_args, a_rng) for _ in range(count))
+		lines.append("")
+	return "\n".join(lines)
+
+def parse_arguments():
+	parser = argparse.ArgumentParser(description="generate synthetic _SWAP.ini files for profiling")
+	parser.add_argument("--output", type=str, help="output folder", default="swap_corpus")
+	parser.add_argument("--files", type=int, help="number of ini files", default=50)
+	parser.add_argument("--entries", type=int, help="entries per ini file", default=2000)
+	parser.add_argument("--plugin", type=str, help="plugin used for generated formIDs", default="Fallout4.esm")
+	parser.add_argument("--forms", type=str, help="file with one form (formID~plugin or editorID) per line, used instead of random formIDs")
+	parser.add_argument("--seed", type=int, help="random seed", default=0)
+	return parser.parse_args()
+
+def main():
+	args = parse_arguments()
+	if args.forms:
+		with open(args.forms, "r") as file:
+			args.forms = [line.strip() for line in file if line.strip()]
+
+	rng = random.Random(args.seed)
+
+	try:
+		os.mkdir(args.output)
+	except FileExistsError:
+		pass
+
+	total = 0
+	for i in range(args.files):
+		path = os.path.join(args.output, "BOSCorpus{:03}_SWAP.ini".format(i))
+		with open(path, "w") as file:
+			text = make_ini(args, rng)
+			total += len(text)
+			file.write(text)
+
+	print("wrote {} files, {} entries, {:.2f} MB".format(args.files, args.files * args.entries, total / (1024 * 1024)))
+
+if __name__ == "__main__":
+	main()
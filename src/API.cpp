@@ -0,0 +1,16 @@
+#include "BOSAPI.h"
+#include "Manager.h"
+
+extern "C" DLLEXPORT std::uint32_t BOS_GetVersion()
+{
+	return BOSAPI::VERSION;
+}
+
+extern "C" DLLEXPORT bool BOS_RegisterRules(const char* a_source, const BOSAPI::Rule* a_rules, std::uint32_t a_count, std::int32_t a_priority)
+{
+	if (!a_rules || a_count == 0) {
+		return false;
+	}
+
+	return FormSwap::Manager::GetSingleton()->RegisterRules(a_source ? a_source : "unknown", std::span(a_rules, a_count), a_priority);
+}
@@ -0,0 +1,65 @@
+#include "CellDataCache.h"
+
+CellData::CellData(RE::TESObjectCELL* a_cell)
+{
+	if (const auto regionList = a_cell ? a_cell->GetRegionList(false) : nullptr) {
+		for (const auto& region : *regionList) {
+			if (region) {
+				regionIDs.push_back(region->GetFormID());
+			}
+		}
+		std::ranges::sort(regionIDs);
+	}
+}
+
+void CellDataCache::Reset()
+{
+	cells.clear();
+}
+
+CellDataCache::Ptr CellDataCache::Find(RE::TESObjectCELL* a_cell) const
+{
+	const auto cellID = a_cell->GetFormID();
+	return cells.read(cellID, [&](const auto& a_cells) -> Ptr {
+		if (const auto it = a_cells.find(cellID); it != a_cells.end()) {
+			hits.fetch_add(1, std::memory_order_relaxed);
+			return it->second;
+		}
+		return nullptr;
+	});
+}
+
+CellDataCache::Ptr CellDataCache::Insert(RE::TESObjectCELL* a_cell, CellData&& a_data)
+{
+	auto data = std::make_shared<const CellData>(std::move(a_data));
+
+	const auto cellID = a_cell->GetFormID();
+	return cells.write(cellID, [&](auto& a_cells) { return a_cells.try_emplace(cellID, std::move(data)).first->second; });
+}
+
+void CellDataCache::RecordMiss(std::uint64_t a_nanoseconds) const
+{
+	misses.fetch_add(1, std::memory_order_relaxed);
+	missTime.fetch_add(a_nanoseconds, std::memory_order_relaxed);
+}
+
+void CellDataCache::LogStats()
+{
+	const auto hitCount = hits.exchange(0);
+	const auto missCount = misses.exchange(0);
+	const auto missNs = missTime.exchange(0);
+
+	if (hitCount + missCount == 0) {
+		return;
+	}
+
+	// a hit skips one region list walk, so the average build time is the saving per hit
+	const auto avgMiss = missCount > 0 ? static_cast<double>(missNs) / static_cast<double>(missCount) : 0.0;
+
+	logger::info("cell data : {} cells cached, {} hits, {} misses ({:.1f}% hit rate), ~{:.0f} ns per build",
+		cells.size(),
+		hitCount,
+		missCount,
+		100.0 * static_cast<double>(hitCount) / static_cast<double>(hitCount + missCount),
+		avgMiss);
+}
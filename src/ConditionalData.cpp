@@ -1,7 +1,14 @@
 #include "ConditionalData.h"
+#include "LoadErrors.h"
+#include "LoadProfiler.h"
+#include "MemoryReport.h"
 
 ConditionFilters::ConditionFilters(std::vector<std::string>& a_conditions)
 {
+	LoadProfiler::ScopedTimer timer(LoadProfiler::STAGE::kConditionFilters,
+		std::accumulate(a_conditions.begin(), a_conditions.end(), std::size_t(0), [](std::size_t a_size, const auto& a_str) { return a_size + a_str.size(); }),
+		a_conditions.size());
+
 	NOT.reserve(a_conditions.size());
 	MATCH.reserve(a_conditions.size());
 
@@ -11,15 +18,212 @@ ConditionFilters::ConditionFilters(std::vector<std::string>& a_conditions)
 			condition.erase(0, 1);
 			negate = true;
 		}
-		if (const auto processedID = util::GetFormID(condition); processedID != 0) {
+		if (SpatialIndex::IsSpatialFilter(condition)) {
+			if (const auto spatialID = SpatialIndex::GetSingleton()->Parse(condition)) {
+				negate ? NOT.emplace_back(*spatialID) : MATCH.emplace_back(*spatialID);
+			} else {
+				// kept as an editorID no form has, so the section doesn't become unconditional
+				negate ? NOT.emplace_back(condition) : MATCH.emplace_back(condition);
+			}
+		} else if (const auto processedID = util::GetFormID(condition); processedID != 0) {
 			negate ? NOT.emplace_back(processedID) : MATCH.emplace_back(processedID);
 		} else {
-			logger::error("\t\tFilter [{}] INFO - unable to find form, treating filter as FF keyword or cell editorID", condition);
+			LoadErrors::GetSingleton()->Report(LoadErrors::TYPE::kFilterNotFound, condition);
 			negate ? NOT.emplace_back(condition) : MATCH.emplace_back(condition);
 		}
 	}
 }
 
+std::string GetProfileKey(const FilterData& a_data)
+{
+	return std::visit(overload{
+						  [](RE::FormID a_formID) {
+							  if (const auto form = RE::TESForm::GetFormByID(a_formID)) {
+								  if (const auto file = form->GetFile(0)) {
+									  const auto localID = (a_formID >> 24) == 0xFE ? a_formID & 0xFFF : a_formID & 0xFFFFFF;
+									  return std::format("0x{:X}~{}", localID, file->GetFilename());
+								  }
+							  }
+							  return std::format("0x{:08X}", a_formID);
+						  },
+						  [](const std::string& a_edid) { return a_edid; },
+						  [](SpatialID a_spatialID) { return SpatialIndex::GetSingleton()->GetSource(a_spatialID); } },
+		a_data);
+}
+
+std::optional<RE::FormID> GetFilterScope(const FilterData& a_data)
+{
+	if (const auto spatialID = std::get_if<SpatialID>(&a_data)) {
+		const auto worldspace = SpatialIndex::GetSingleton()->GetWorldspace(*spatialID);
+		return worldspace != 0 ? std::optional(worldspace) : std::nullopt;
+	}
+
+	const auto formID = std::get_if<RE::FormID>(&a_data);
+	const auto form = formID ? RE::TESForm::GetFormByID(*formID) : nullptr;
+	if (!form) {
+		return std::nullopt;
+	}
+
+	switch (form->GetFormType()) {
+	case RE::FormType::kCELL:
+		{
+			const auto cell = form->As<RE::TESObjectCELL>();
+			if (cell->IsInterior()) {
+				return kInteriorScope;
+			}
+			return cell->worldSpace ? std::optional(cell->worldSpace->GetFormID()) : std::nullopt;
+		}
+	case RE::FormType::kREGN:
+		{
+			// regions are only attached to exterior cells of their worldspace
+			const auto region = form->As<RE::TESRegion>();
+			return region->worldSpace ? std::optional(region->worldSpace->GetFormID()) : std::nullopt;
+		}
+	default:
+		return std::nullopt;
+	}
+}
+
+std::string ConditionFilters::GetProfileKey() const
+{
+	const auto join = [](const std::vector<FilterData>& a_filters) {
+		std::vector<std::string> keys;
+		keys.reserve(a_filters.size());
+		for (const auto& filter : a_filters) {
+			keys.push_back(::GetProfileKey(filter));
+		}
+		std::ranges::sort(keys);
+		return string::join(keys, ";");
+	};
+
+	return std::format("NOT({}) MATCH({})", join(NOT), join(MATCH));
+}
+
+std::uint64_t ConditionFilterRegistry::hash(const ConditionFilters& a_filters)
+{
+	std::uint64_t seed = a_filters.NOT.size();
+
+	const auto combine = [&](std::uint64_t a_value) {
+		seed ^= a_value + 0x9E3779B97F4A7C15 + (seed << 6) + (seed >> 2);
+	};
+
+	const auto hash_filters = [&](const std::vector<FilterData>& a_filters) {
+		for (const auto& filter : a_filters) {
+			combine(filter.index());
+			std::visit(overload{
+						   [&](RE::FormID a_formID) { combine(a_formID); },
+						   [&](const std::string& a_edid) { combine(ankerl::unordered_dense::hash<std::string>{}(a_edid)); },
+						   [&](SpatialID a_spatialID) { combine(a_spatialID.value); } },
+				filter);
+		}
+	};
+
+	hash_filters(a_filters.NOT);
+	hash_filters(a_filters.MATCH);
+
+	return seed;
+}
+
+const ConditionFilters* ConditionFilterRegistry::Intern(const ConditionFilters& a_filters)
+{
+	internCount++;
+
+	auto& bucket = buckets[hash(a_filters)];
+	for (const auto index : bucket) {
+		if (filterSets[index] == a_filters) {
+			uses[index]++;
+			return std::addressof(filterSets[index]);
+		}
+	}
+
+	const auto index = static_cast<std::uint32_t>(filterSets.size());
+	bucket.push_back(index);
+
+	auto& filterSet = filterSets.emplace_back(a_filters);
+	filterSet.id = index;
+	uses.push_back(1);
+
+	return std::addressof(filterSet);
+}
+
+void ConditionFilterRegistry::AssignIDs()
+{
+	std::vector<std::uint32_t> order(filterSets.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::ranges::stable_sort(order, std::greater{}, [&](std::uint32_t a_index) { return uses[a_index]; });
+
+	for (std::uint32_t id = 0; id < order.size(); ++id) {
+		filterSets[order[id]].id = id;
+	}
+}
+
+std::size_t ConditionFilterRegistry::GetHeapBytes() const
+{
+	std::size_t bytes = filterSets.size() * sizeof(ConditionFilters) + uses.capacity() * sizeof(std::uint32_t);
+	for (const auto& filterSet : filterSets) {
+		for (const auto* filters : { &filterSet.NOT, &filterSet.MATCH }) {
+			bytes += filters->capacity() * sizeof(FilterData);
+			for (const auto& filter : *filters) {
+				if (const auto edid = std::get_if<std::string>(&filter)) {
+					bytes += MemoryReport::string_bytes(*edid);
+				}
+			}
+		}
+	}
+	return bytes;
+}
+
+void ConditionFilterRegistry::OrderAtoms()
+{
+	const auto profile = FilterProfile::GetSingleton();
+
+	// rough ns per check until an atom has been profiled
+	constexpr auto get_default_cost = [](const FilterData& a_filter) {
+		switch (a_filter.index()) {
+		case 0:
+			return 60.0;  // form lookup
+		case 1:
+			return 300.0;  // string compares against the cell, location and base keywords
+		default:
+			return 20.0;  // binary search of the spatial matches
+		}
+	};
+
+	std::size_t reordered = 0;
+
+	const auto order = [&](std::vector<FilterData>& a_filters) {
+		if (a_filters.size() < 2) {
+			return;
+		}
+		std::vector<std::pair<double, std::uint32_t>> scored;
+		scored.reserve(a_filters.size());
+		for (std::uint32_t i = 0; i < a_filters.size(); ++i) {
+			scored.emplace_back(profile->GetScore(GetProfileKey(a_filters[i]), get_default_cost(a_filters[i])), i);
+		}
+		std::ranges::stable_sort(scored, {}, &std::pair<double, std::uint32_t>::first);
+		if (std::ranges::is_sorted(scored, {}, &std::pair<double, std::uint32_t>::second)) {
+			return;
+		}
+
+		std::vector<FilterData> sorted;
+		sorted.reserve(a_filters.size());
+		for (const auto index : scored | std::views::values) {
+			sorted.push_back(std::move(a_filters[index]));
+		}
+		a_filters = std::move(sorted);
+		reordered++;
+	};
+
+	for (auto& filterSet : filterSets) {
+		order(filterSet.NOT);
+		order(filterSet.MATCH);
+	}
+
+	if (reordered > 0) {
+		logger::info("{} filter lists reordered by expected cost", reordered);
+	}
+}
+
 bool ConditionalInput::IsValid(RE::FormID a_formID) const
 {
 	if (const auto form = RE::TESForm::GetFormByID(a_formID)) {
@@ -27,26 +231,19 @@ bool ConditionalInput::IsValid(RE::FormID a_formID) const
 		case RE::FormType::kLCTN:
 			{
 				const auto location = form->As<RE::BGSLocation>();
+				const auto currentLocation = context.GetLocation();
 				return currentLocation && (currentLocation == location || currentLocation->IsParent(location));
 			}
 		case RE::FormType::kREGN:
-			{
-				if (const auto region = form->As<RE::TESRegion>()) {
-					if (currentRegionList) {
-						return std::any_of(currentRegionList->begin(), currentRegionList->end(), [&](const auto& regionInList) {
-							return regionInList && regionInList == region;
-						});
-					}
-				}
-				return false;
-			}
+			return context.GetCellData().HasRegion(a_formID);
 		case RE::FormType::kKYWD:
 			{
 				const auto keyword = form->As<RE::BGSKeyword>();
-				return currentLocation && currentLocation->HasKeyword(keyword) || ref->HasKeyword(keyword);
+				const auto currentLocation = context.GetLocation();
+				return currentLocation && currentLocation->HasKeyword(keyword) || context.GetRef()->HasKeyword(keyword);
 			}
 		case RE::FormType::kCELL:
-			return currentCell == form;
+			return context.GetCell() == form;
 		default:
 			break;
 		}
@@ -57,22 +254,27 @@ bool ConditionalInput::IsValid(RE::FormID a_formID) const
 
 bool ConditionalInput::IsValid(const std::string& a_edid) const
 {
-	if (currentCell && string::iequals(currentCell->GetFormEditorID(), a_edid)) {
+	if (const auto currentCell = context.GetCell(); currentCell && string::iequals(currentCell->GetFormEditorID(), a_edid)) {
 		return true;
 	}
 	
-	if (currentLocation && currentLocation->HasKeywordString(a_edid)) {
+	if (const auto currentLocation = context.GetLocation(); currentLocation && currentLocation->HasKeywordString(a_edid)) {
 		return true;
 	}
 
-	if (const auto keywordForm = base->As<RE::BGSKeywordForm>()) {
+	if (const auto keywordForm = context.GetBase()->As<RE::BGSKeywordForm>()) {
 		return keywordForm->HasKeywordString(a_edid);
 	}
 
 	return false;
 }
 
-bool ConditionalInput::IsValid(const FormIDStr& a_data) const
+bool ConditionalInput::IsValid(SpatialID a_spatialID) const
+{
+	return std::ranges::binary_search(context.GetSpatialMatches(), a_spatialID.value);
+}
+
+bool ConditionalInput::IsValid(const FilterData& a_data) const
 {
 	bool result = false;
 	
@@ -82,13 +284,33 @@ bool ConditionalInput::IsValid(const FormIDStr& a_data) const
 				   },
 				   [&](const std::string& a_edid) {
 					   result = IsValid(a_edid);
+				   },
+				   [&](SpatialID a_spatialID) {
+					   result = IsValid(a_spatialID);
 				   } },
 		a_data);
 
 	return result;
 }
 
+std::optional<RE::FormID> ConditionalInput::GetScope() const
+{
+	const auto cell = context.GetCell();
+	if (!cell) {
+		return std::nullopt;
+	}
+	if (cell->IsInterior()) {
+		return kInteriorScope;
+	}
+	return cell->worldSpace ? std::optional(cell->worldSpace->GetFormID()) : std::nullopt;
+}
+
 bool ConditionalInput::IsValid(const ConditionFilters& a_filters) const
+{
+	return context.GetFilterSetResult(a_filters.id, [&] { return IsValidUncached(a_filters); });
+}
+
+bool ConditionalInput::IsValidUncached(const ConditionFilters& a_filters) const
 {
 	if (!a_filters.NOT.empty()) {
 		if (std::ranges::any_of(a_filters.NOT, [this](const auto& data) { return IsValid(data); })) {
@@ -0,0 +1,73 @@
+#include "ConflictReport.h"
+
+namespace detail
+{
+	// quoted if it contains a separator, records often do
+	std::string csv_field(std::string_view a_str)
+	{
+		if (a_str.find_first_of(",\"\n") == std::string_view::npos) {
+			return std::string(a_str);
+		}
+		std::string result{ '"' };
+		for (const auto ch : a_str) {
+			if (ch == '"') {
+				result += '"';
+			}
+			result += ch;
+		}
+		result += '"';
+		return result;
+	}
+}
+
+std::filesystem::path ConflictReport::get_path()
+{
+	auto path = logger::log_directory().value_or(std::filesystem::path{});
+	path /= Version::PROJECT;
+	path += "_Conflicts.csv"sv;
+	return path;
+}
+
+void ConflictReport::Add(std::string_view a_section, std::string a_key, std::string a_filters, std::span<const Rule> a_rules)
+{
+	if (a_rules.size() < 2 || a_rules.back().chance != 100.0f) {  // randomized winners fall through to earlier rules
+		return;
+	}
+
+	conflicts.push_back({ a_section, std::move(a_key), std::move(a_filters), { a_rules.begin(), a_rules.end() } });
+}
+
+std::size_t ConflictReport::Write()
+{
+	std::ranges::sort(conflicts, [](const Conflict& a_lhs, const Conflict& a_rhs) {
+		return std::tie(a_lhs.section, a_lhs.key, a_lhs.filters) < std::tie(a_rhs.section, a_rhs.key, a_rhs.filters);
+	});
+
+	for (const auto& [section, key, filters, rules] : conflicts) {
+		const auto& winner = rules.back();
+		if (filters.empty()) {
+			logger::warn("\t[{}] {} : {} ({}) wins, {} conflicts", section, key, winner.record, winner.path, rules.size() - 1);
+		} else {
+			logger::warn("\t[{}] {} {} : {} ({}) wins, {} conflicts", section, key, filters, winner.record, winner.path, rules.size() - 1);
+		}
+	}
+
+	std::ofstream file(get_path(), std::ios::trunc);
+	if (!file) {
+		logger::error("Failed to write conflict report {}", get_path().string());
+		return conflicts.size();
+	}
+
+	file << "section,key,filters,result,record,path\n";
+	for (const auto& [section, key, filters, rules] : conflicts) {
+		for (auto it = rules.rbegin(); it != rules.rend(); ++it) {
+			file << section << ',' << detail::csv_field(key) << ',' << detail::csv_field(filters) << ','
+				 << (it == rules.rbegin() ? "winner"sv : "shadowed"sv) << ','
+				 << detail::csv_field(it->record) << ',' << detail::csv_field(it->path) << '\n';
+		}
+	}
+
+	logger::info("{} conflicts written to {}", conflicts.size(), get_path().string());
+
+	return conflicts.size();
+}
@@ -0,0 +1,55 @@
+#include "ConsoleCommands.h"
+#include "Manager.h"
+
+namespace ConsoleCommands
+{
+	namespace
+	{
+		// unused in the retail game, renamed to "bos"
+		constexpr auto replacedCommand{ "BetaComment"sv };
+		constexpr auto helpString{ "bos [explain|memory] : trace the swap rules for the selected reference, or log rule memory usage"sv };
+
+		bool Execute(const RE::SCRIPT_PARAMETER* a_parameters, const char* a_compiledParams, RE::TESObjectREFR* a_refObject, RE::TESObjectREFR* a_container, RE::Script* a_script, RE::ScriptLocals* a_scriptLocals, float&, std::uint32_t& a_offset)
+		{
+			std::array<char, 512> arg{};  // ParseParameters copies the whole string argument, it isn't told the buffer size
+			RE::Script::ParseParameters(a_parameters, a_compiledParams, a_offset, a_refObject, a_container, a_script, a_scriptLocals, arg.data());
+
+			const auto console = RE::ConsoleLog::GetSingleton();
+			const auto manager = FormSwap::Manager::GetSingleton();
+
+			if (const std::string_view command(arg.data()); command.empty() || string::iequals(command, "explain"sv)) {
+				manager->ExplainSwapData(a_refObject);
+			} else if (string::iequals(command, "memory"sv)) {
+				manager->LogMemoryReport();
+				console->PrintLine(std::format("[BOS] memory report written to {}.log", Version::PROJECT).c_str());
+			} else {
+				console->PrintLine(helpString.data());
+			}
+
+			return true;
+		}
+	}
+
+	void Install()
+	{
+		const auto function = RE::SCRIPT_FUNCTION::LocateConsoleCommand(replacedCommand);
+		if (!function) {
+			logger::warn("Console command {} not found, bos commands are unavailable", replacedCommand);
+			return;
+		}
+
+		static RE::SCRIPT_PARAMETER params[] = {
+			{ "String (optional)", RE::SCRIPT_PARAM_TYPE::kChar, true }
+		};
+
+		function->functionName = "bos";
+		function->shortName = "";
+		function->helpString = helpString.data();
+		function->referenceFunction = false;
+		function->paramCount = static_cast<std::uint16_t>(std::size(params));
+		function->parameters = params;
+		function->executeFunction = Execute;
+
+		logger::info("Installed bos console command");
+	}
+}
@@ -0,0 +1,124 @@
+#include "FilterProfile.h"
+#include "Settings.h"
+
+std::filesystem::path FilterProfile::get_path()
+{
+	auto path = logger::log_directory().value_or(std::filesystem::path{});
+	path /= Version::PROJECT;
+	path += "_FilterProfile.csv"sv;
+	return path;
+}
+
+void FilterProfile::Load()
+{
+	profile.clear();
+
+	std::ifstream file(get_path());
+	if (!file) {
+		return;
+	}
+
+	// key,evaluations,hits,nanoseconds
+	// keys can contain commas, so the counters are read from the end
+	std::string line;
+	while (std::getline(file, line)) {
+		Counters    counters;
+		std::size_t end = line.size();
+		bool        valid = true;
+		for (auto* value : { &counters.nanoseconds, &counters.hits, &counters.evaluations }) {
+			const auto pos = end > 0 ? line.rfind(',', end - 1) : std::string::npos;
+			if (pos == std::string::npos) {
+				valid = false;
+				break;
+			}
+			std::from_chars(line.data() + pos + 1, line.data() + end, *value);
+			end = pos;
+		}
+		if (valid) {
+			profile.insert_or_assign(line.substr(0, end), counters);
+		}
+	}
+
+	logger::info("Loaded filter profile with {} entries", profile.size());
+}
+
+void FilterProfile::Start()
+{
+	enabled = Settings::GetSingleton()->profileFilters && !slotKeys.empty();
+	if (enabled) {
+		slots = std::make_unique<Slot[]>(slotKeys.size());
+
+		logger::info("Profiling {} filter atoms and rules", slotKeys.size());
+	}
+}
+
+void FilterProfile::Save() const
+{
+	if (!enabled) {
+		return;
+	}
+
+	auto merged = profile;
+	for (std::uint32_t i = 0; i < slotKeys.size(); ++i) {
+		auto& counters = merged[slotKeys[i]];
+		counters.evaluations += slots[i].evaluations.load(std::memory_order_relaxed);
+		counters.hits += slots[i].hits.load(std::memory_order_relaxed);
+		counters.nanoseconds += slots[i].nanoseconds.load(std::memory_order_relaxed);
+	}
+
+	std::ofstream file(get_path(), std::ios::trunc);
+	if (!file) {
+		logger::error("Failed to write filter profile {}", get_path().string());
+		return;
+	}
+
+	for (const auto& [key, counters] : merged) {
+		file << key << ',' << counters.evaluations << ',' << counters.hits << ',' << counters.nanoseconds << '\n';
+	}
+}
+
+std::uint32_t FilterProfile::GetSlot(const std::string& a_key)
+{
+	const auto [it, inserted] = slotIndices.try_emplace(a_key, static_cast<std::uint32_t>(slotKeys.size()));
+	if (inserted) {
+		slotKeys.push_back(a_key);
+	}
+	return it->second;
+}
+
+std::optional<FilterProfile::Counters> FilterProfile::GetProfile(const std::string& a_key) const
+{
+	if (const auto it = profile.find(a_key); it != profile.end()) {
+		return it->second;
+	}
+	return std::nullopt;
+}
+
+double FilterProfile::GetScore(const std::string& a_key, double a_defaultCost) const
+{
+	const auto counters = GetProfile(a_key);
+	if (!counters || counters->evaluations < minSamples) {
+		return a_defaultCost * 2.0;  // assume a 50% hit rate
+	}
+
+	const auto evaluations = static_cast<double>(counters->evaluations);
+	const auto cost = static_cast<double>(counters->nanoseconds) / evaluations;
+	const auto hitRate = std::max(static_cast<double>(counters->hits) / evaluations, 1.0 / evaluations);
+
+	return cost / hitRate;
+}
+
+void FilterProfile::Record(std::uint32_t a_slot, bool a_hit) const
+{
+	auto& slot = slots[a_slot];
+	slot.evaluations.fetch_add(1, std::memory_order_relaxed);
+	if (a_hit) {
+		slot.hits.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+void FilterProfile::Record(std::uint32_t a_slot, bool a_hit, std::uint64_t a_nanoseconds) const
+{
+	Record(a_slot, a_hit);
+	slots[a_slot].nanoseconds.fetch_add(a_nanoseconds, std::memory_order_relaxed);
+}
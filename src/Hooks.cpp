@@ -1,7 +1,20 @@
 #include "Hooks.h"
+#include "TraceRecorder.h"
 
 namespace BaseObjectSwapper
 {
+	namespace
+	{
+		struct SpawnStats
+		{
+			std::atomic<std::uint64_t> calls{ 0 };
+			std::atomic<std::uint64_t> evaluated{ 0 };
+			std::atomic<std::uint64_t> evaluatedNS{ 0 };
+		};
+
+		std::array<SpawnStats, std::to_underlying(FormSwap::HOOK_TYPE::kTotal)> spawnStats{};
+	}
+
 	void detail::swap_base(RE::TESObjectREFR* a_ref)
 	{
 		if (const auto base = a_ref->GetObjectReference()) {
@@ -12,10 +25,21 @@ namespace BaseObjectSwapper
 				materialSwapForm = materialSwap->swapForm;
 			}
 			
-			const auto& [swapBase, objectProperties] = FormSwap::Manager::GetSingleton()->GetSwapData(a_ref, base, materialSwapForm);
+			const RefContext context(a_ref, base);
+
+			const auto recorder = TraceRecorder::GetSingleton();
+			const bool restored = recorder->IsRecording() && FormSwap::Manager::GetSingleton()->GetSwapDecision(context).has_value();
+
+			const auto  swapData = FormSwap::Manager::GetSingleton()->GetSwapData(context, materialSwapForm);
+			const auto& [swapBase, objectProperties] = swapData;
+
+			if (recorder->IsRecording()) {
+				recorder->Record(context, materialSwapForm, swapBase != base ? swapBase : nullptr, restored);
+			}
 
 			if (swapBase && swapBase != base) {
 				a_ref->SetObjectReference(swapBase);
+				FormSwap::Manager::GetSingleton()->InsertSwapDecision(context, swapData);
 
 				if (a_ref->extraList && a_ref->extraList->HasType(RE::EXTRA_DATA_TYPE::kLevelItem)) {
 					FormSwap::Manager::GetSingleton()->InsertLeveledItemRef(a_ref);
@@ -23,12 +47,50 @@ namespace BaseObjectSwapper
 			}
 
 			if (objectProperties) {
-				objectProperties->SetTransform(a_ref);
+				objectProperties->SetTransform(context);
 				objectProperties->SetRecordFlags(a_ref);
 			}
 		}
 	}
 
+	void detail::swap_spawned_base(RE::TESObjectREFR* a_ref, FormSwap::HOOK_TYPE a_type)
+	{
+		auto& stats = spawnStats[std::to_underlying(a_type)];
+		stats.calls.fetch_add(1, std::memory_order_relaxed);
+
+		const auto manager = FormSwap::Manager::GetSingleton();
+		manager->LoadFormsOnce();
+
+		if (!manager->HasHookRules(a_type, a_ref)) {
+			return;
+		}
+
+		const auto start = std::chrono::steady_clock::now();
+		swap_base(a_ref);
+		stats.evaluated.fetch_add(1, std::memory_order_relaxed);
+		stats.evaluatedNS.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+	}
+
+	void LogStats()
+	{
+		constexpr std::array hookNames{ "references"sv, "projectiles"sv, "hazards"sv };
+
+		for (const auto type : { FormSwap::HOOK_TYPE::kProjectile, FormSwap::HOOK_TYPE::kHazard }) {
+			auto&      stats = spawnStats[std::to_underlying(type)];
+			const auto calls = stats.calls.exchange(0);
+			const auto evaluated = stats.evaluated.exchange(0);
+			const auto evaluatedNS = stats.evaluatedNS.exchange(0);
+
+			if (calls == 0) {
+				continue;
+			}
+
+			logger::info("{} spawned {}, {} skipped without a rule lookup, {} evaluated ({:.0f} ns avg)",
+				calls, hookNames[std::to_underlying(type)], calls - evaluated, evaluated,
+				evaluated > 0 ? static_cast<double>(evaluatedNS) / static_cast<double>(evaluated) : 0.0);
+		}
+	}
+
 	void Install()
 	{
 		logger::info("{:*^30}", "HOOKS");
@@ -0,0 +1,183 @@
+#include "LeveledList.h"
+
+namespace FormSwap
+{
+	namespace
+	{
+		// TESLeveledList::llFlags
+		enum : std::int8_t
+		{
+			kCalculateFromAllLevels = 1 << 0,
+			kUseAll = 1 << 2
+		};
+
+		constexpr std::uint32_t maxDepth = 16;
+
+		std::span<const RE::LEVELED_OBJECT> get_entries(const RE::TESLeveledList* a_list)
+		{
+			if (!a_list->leveledLists || a_list->baseListCount <= 0) {
+				return {};
+			}
+			return { a_list->leveledLists, static_cast<std::size_t>(a_list->baseListCount) };
+		}
+
+		float get_chance(std::int8_t a_chanceNone)
+		{
+			return 1.0f - std::clamp(static_cast<float>(a_chanceNone), 0.0f, 100.0f) / 100.0f;
+		}
+	}
+
+	FlatLeveledList::FlatLeveledList(const RE::TESLevItem* a_list) :
+		scriptListCount(a_list->scriptListCount)
+	{
+		if (!IsFlattenable(a_list, 0)) {
+			return;
+		}
+
+		// a new bracket starts at every level used anywhere in the tree
+		std::vector<std::uint16_t> levels{ 0 };
+		CollectLevels(a_list, levels, 0);
+		std::ranges::sort(levels);
+		levels.erase(std::ranges::unique(levels).begin(), levels.end());
+
+		brackets.reserve(levels.size());
+		for (const auto level : levels) {
+			const auto begin = static_cast<std::uint32_t>(candidates.size());
+			Resolve(a_list, level, 1.0f, 0);
+			brackets.push_back({ level, begin, static_cast<std::uint32_t>(candidates.size()) });
+		}
+
+		// running totals, so picks can binary search
+		for (const auto& bracket : brackets) {
+			float total = 0.0f;
+			for (auto i = bracket.begin; i < bracket.end; ++i) {
+				total += candidates[i].cumulativeWeight;
+				candidates[i].cumulativeWeight = total;
+			}
+		}
+
+		candidates.shrink_to_fit();
+	}
+
+	bool FlatLeveledList::IsValid(const RE::TESLevItem* a_list) const
+	{
+		// script added entries aren't part of the table
+		return !brackets.empty() && a_list->scriptListCount == scriptListCount;
+	}
+
+	bool FlatLeveledList::empty() const
+	{
+		return brackets.empty();
+	}
+
+	RE::TESBoundObject* FlatLeveledList::Pick(std::uint16_t a_level, const BOS_RNG& a_rng) const
+	{
+		const auto bracketIt = std::ranges::upper_bound(brackets, a_level, {}, &Bracket::minLevel);
+		if (bracketIt == brackets.begin()) {
+			return nullptr;
+		}
+
+		const auto& bracket = *std::prev(bracketIt);
+		if (bracket.begin == bracket.end) {
+			return nullptr;
+		}
+
+		const auto first = candidates.begin() + bracket.begin;
+		const auto last = candidates.begin() + bracket.end;
+
+		// weights that don't add up to 1 are the chance of the list returning nothing
+		const auto roll = a_rng.generate<float>(0.0f, 1.0f);
+		const auto it = std::upper_bound(first, last, roll, [](float a_roll, const Candidate& a_candidate) {
+			return a_roll < a_candidate.cumulativeWeight;
+		});
+
+		return it != last ? it->object : nullptr;
+	}
+
+	void FlatLeveledList::CollectLevels(const RE::TESLeveledList* a_list, std::vector<std::uint16_t>& a_levels, std::uint32_t a_depth)
+	{
+		for (const auto& entry : get_entries(a_list)) {
+			a_levels.push_back(entry.level);
+			if (const auto nestedList = entry.form ? entry.form->As<RE::TESLevItem>() : nullptr; nestedList && a_depth < maxDepth) {
+				CollectLevels(nestedList, a_levels, a_depth + 1);
+			}
+		}
+	}
+
+	bool FlatLeveledList::IsFlattenable(const RE::TESLeveledList* a_list, std::uint32_t a_depth)
+	{
+		// globals and keyword chances can change at runtime
+		if (a_depth > maxDepth || a_list->chanceGlobal || a_list->keywordChanceCount > 0) {
+			return false;
+		}
+
+		return std::ranges::all_of(get_entries(a_list), [&](const auto& a_entry) {
+			const auto nestedList = a_entry.form ? a_entry.form->As<RE::TESLevItem>() : nullptr;
+			return !nestedList || IsFlattenable(nestedList, a_depth + 1);
+		});
+	}
+
+	void FlatLeveledList::Resolve(const RE::TESLeveledList* a_list, std::uint16_t a_level, float a_weight, std::uint32_t a_depth)
+	{
+		a_weight *= get_chance(a_list->chanceNone);
+
+		const auto entries = get_entries(a_list);
+
+		std::uint16_t maxLevel = 0;
+		std::size_t   numEligible = 0;
+		for (const auto& entry : entries) {
+			if (entry.level <= a_level) {
+				maxLevel = std::max(maxLevel, entry.level);
+			}
+		}
+
+		const bool allLevels = (a_list->llFlags & kCalculateFromAllLevels) != 0;
+		const auto is_eligible = [&](const RE::LEVELED_OBJECT& a_entry) {
+			return a_entry.form && a_entry.level <= a_level && (allLevels || a_entry.level == maxLevel);
+		};
+
+		for (const auto& entry : entries) {
+			if (is_eligible(entry)) {
+				numEligible++;
+			}
+		}
+
+		if (numEligible == 0 || a_weight <= 0.0f) {
+			return;
+		}
+
+		if (a_list->llFlags & kUseAll) {
+			// every entry is added, the first one that passes its chance ends up in front
+			float remaining = a_weight;
+			for (const auto& entry : entries) {
+				if (is_eligible(entry)) {
+					const auto taken = remaining * get_chance(entry.chanceNone);
+					AddEntry(entry, a_level, taken, a_depth);
+					remaining -= taken;
+				}
+			}
+		} else {
+			const auto weight = a_weight / static_cast<float>(numEligible);
+			for (const auto& entry : entries) {
+				if (is_eligible(entry)) {
+					AddEntry(entry, a_level, weight * get_chance(entry.chanceNone), a_depth);
+				}
+			}
+		}
+	}
+
+	void FlatLeveledList::AddEntry(const RE::LEVELED_OBJECT& a_entry, std::uint16_t a_level, float a_weight, std::uint32_t a_depth)
+	{
+		if (a_weight <= 0.0f) {
+			return;
+		}
+
+		if (const auto nestedList = a_entry.form->As<RE::TESLevItem>()) {
+			if (a_depth < maxDepth) {
+				Resolve(nestedList, a_level, a_weight, a_depth + 1);
+			}
+		} else if (const auto object = a_entry.form->As<RE::TESBoundObject>()) {
+			candidates.push_back({ a_weight, object });
+		}
+	}
+}
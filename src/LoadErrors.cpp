@@ -0,0 +1,75 @@
+#include "LoadErrors.h"
+
+void LoadErrors::Report(TYPE a_type, std::string_view a_entry)
+{
+	std::scoped_lock guard(lock);
+
+	if (counts[std::to_underlying(a_type)]++ >= maxLinesPerType) {
+		return;
+	}
+
+	switch (a_type) {
+	case TYPE::kBaseNotFound:
+		logger::error("\t\t\t\tfail : [{}] (BASE formID not found)", a_entry);
+		break;
+	case TYPE::kSwapNotFound:
+		logger::error("\t\t\t\tfail : [{}] (SWAP formID not found)", a_entry);
+		break;
+	case TYPE::kSwapSetNotFound:
+		logger::error("\t\t\tfail : [{}] (SWAP formID not found)", a_entry);
+		break;
+	case TYPE::kSwapDeleted:
+		logger::error("\t\tfail : [{}] (SWAP form is deleted)", a_entry);
+		break;
+	case TYPE::kSwapNotBoundObject:
+		logger::error("\t\tfail : [{}] (SWAP form is not a bound object)", a_entry);
+		break;
+	case TYPE::kBaseSameAsSwap:
+		logger::error("\t\t\t\tfail : [{}] (BASE formID == SWAP formID)", a_entry);
+		break;
+	case TYPE::kFilterNotFound:
+		logger::error("\t\tFilter [{}] INFO - unable to find form, treating filter as FF keyword or cell editorID", a_entry);
+		break;
+	case TYPE::kFilterFormIDNotFound:
+		logger::error("\t\tFilter [{}] INFO - unable to find form, treating filter as cell formID", a_entry);
+		break;
+	case TYPE::kSpatialMalformed:
+		logger::error("\t\tFilter [{}] INFO - malformed spatial filter, filter never matches", a_entry);
+		break;
+	case TYPE::kSpatialWorldspaceNotFound:
+		logger::error("\t\tFilter [{}] INFO - worldspace not found, filter never matches", a_entry);
+		break;
+	case TYPE::kSpatialArguments:
+		logger::error("\t\tFilter [{}] INFO - wrong number of spatial filter arguments or invalid number, filter never matches", a_entry);
+		break;
+	default:
+		break;
+	}
+}
+
+void LoadErrors::LogSummary()
+{
+	constexpr std::array reasons{
+		"BASE formID not found"sv,
+		"SWAP formID not found"sv,
+		"SWAP formID in set not found"sv,
+		"SWAP form is deleted"sv,
+		"SWAP form is not a bound object"sv,
+		"BASE formID == SWAP formID"sv,
+		"filter treated as FF keyword or cell editorID"sv,
+		"filter treated as cell formID"sv,
+		"malformed spatial filter"sv,
+		"spatial filter worldspace not found"sv,
+		"invalid spatial filter arguments"sv
+	};
+
+	std::scoped_lock guard(lock);
+
+	for (std::uint32_t i = 0; i < counts.size(); ++i) {
+		if (counts[i] > maxLinesPerType) {
+			logger::warn("\t{} more entries : {}", counts[i] - maxLinesPerType, reasons[i]);
+		}
+	}
+
+	counts.fill(0);
+}
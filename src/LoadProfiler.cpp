@@ -0,0 +1,65 @@
+#include "LoadProfiler.h"
+#include "Settings.h"
+
+LoadProfiler::ScopedTimer::ScopedTimer(STAGE a_stage, std::size_t a_bytes, std::size_t a_entries) :
+	stage(a_stage),
+	bytes(a_bytes),
+	entries(a_entries),
+	enabled(IsEnabled())
+{
+	if (enabled) {
+		start = std::chrono::steady_clock::now();
+	}
+}
+
+LoadProfiler::ScopedTimer::~ScopedTimer()
+{
+	if (enabled) {
+		GetSingleton()->Record(stage, std::chrono::steady_clock::now() - start, bytes, entries);
+	}
+}
+
+bool LoadProfiler::IsEnabled()
+{
+	return Settings::GetSingleton()->profileLoad;
+}
+
+void LoadProfiler::Record(STAGE a_stage, std::chrono::nanoseconds a_time, std::size_t a_bytes, std::size_t a_entries)
+{
+	std::scoped_lock guard(lock);
+
+	auto& stat = stats[std::to_underlying(a_stage)];
+	stat.nanoseconds += a_time.count();
+	stat.bytes += a_bytes;
+	stat.entries += a_entries;
+	stat.calls++;
+}
+
+void LoadProfiler::LogResults() const
+{
+	if (!IsEnabled()) {
+		return;
+	}
+
+	constexpr std::array stageNames{ "Read INI"sv, "ConditionFilters"sv, "GetForms"sv, "GetProperties"sv, "split_with_regex"sv };
+
+	logger::info("{:*^30}", "PROFILE");
+
+	std::scoped_lock guard(lock);
+
+	for (std::uint32_t i = 0; i < stats.size(); ++i) {
+		const auto& [nanoseconds, bytes, entries, calls] = stats[i];
+		if (calls == 0) {
+			continue;
+		}
+		const auto seconds = static_cast<double>(nanoseconds) / 1e9;
+		const auto megabytes = static_cast<double>(bytes) / (1024.0 * 1024.0);
+		logger::info("{} : {} entries, {:.2f} MB in {:.2f} ms ({:.2f} MB/s, {:.0f} entries/s)",
+			stageNames[i],
+			entries,
+			megabytes,
+			seconds * 1000.0,
+			seconds > 0.0 ? megabytes / seconds : 0.0,
+			seconds > 0.0 ? static_cast<double>(entries) / seconds : 0.0);
+	}
+}
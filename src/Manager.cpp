@@ -1,4 +1,11 @@
 #include "Manager.h"
+#include "ConflictReport.h"
+#include "Core/INIReader.h"
+#include "LoadErrors.h"
+#include "LoadProfiler.h"
+#include "MemoryReport.h"
+#include "Settings.h"
+#include "ShadowEval.h"
 
 namespace FormSwap
 {
@@ -11,163 +18,951 @@ namespace FormSwap
 
 	void Manager::LoadForms()
 	{
+		const auto startTime = std::chrono::steady_clock::now();
+
 		logger::info("{:*^30}", "INI");
 
+		std::vector<RuleBatch> batches;
+		{
+			std::scoped_lock lock(pendingLock);
+			batches = std::move(pendingBatches);
+			formsLoaded = true;
+		}
+
+		std::ranges::stable_sort(batches, {}, &RuleBatch::priority);
+		const auto iniPos = std::ranges::partition_point(batches, [](const auto& a_batch) { return a_batch.priority < 0; });
+
+		for (auto& batch : std::ranges::subrange(batches.begin(), iniPos)) {
+			ApplyRuleBatch(batch);
+		}
+
+		LoadINIs();
+
+		for (auto& batch : std::ranges::subrange(iniPos, batches.end())) {
+			ApplyRuleBatch(batch);
+		}
+
+		FinishLazyRules();
+
+		if (swapForms.empty() && swapRefs.empty() && swapFormsConditional.empty() && wildcards.empty() && refProperties.empty() && refPropertiesConditional.empty() &&
+			lazySwapForms.empty() && lazySwapRefs.empty() && lazyRefProperties.empty()) {
+			logger::warn("No swaps or property overrides were found, aborting...");
+			return;
+		}
+
+		ResolveSwapForms();
+		BuildLeveledListCache();
+		SpatialIndex::GetSingleton()->Build();
+		CompileConditionalLists();
+		BuildHookCategories();
+
+		logger::info("{:*^30}", "RESULT");
+
+		logger::info("{} form-form swaps", swapForms.size() + lazySwapForms.size());
+		logger::info("{} conditional form swaps", swapFormsConditional.size());
+		logger::info("{} ref-form swaps", swapRefs.size() + lazySwapRefs.size());
+		logger::info("{} keyword/type wildcard swaps", wildcards.size());
+		logger::info("{} ref property overrides", refProperties.size() + lazyRefProperties.size());
+		logger::info("{} conditional ref property overrides", refPropertiesConditional.size());
+		logger::info("{} flattened leveled lists", flatLeveledLists.size());
+
+		LoadProfiler::GetSingleton()->LogResults();
+		LogMemoryReport();
+		logger::info("Loaded in {} ms", std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count());
+
+		logger::info("{:*^30}", "END");
+
+		spdlog::default_logger()->flush();
+
+		// the maps are read-only from here on
+		conflictWorker = std::jthread([this](std::stop_token a_token) { AnalyzeConflicts(a_token); });
+	}
+
+	void Manager::AnalyzeConflicts(std::stop_token a_token)
+	{
+		const auto startTime = std::chrono::steady_clock::now();
+
+		ConflictReport                    report;
+		std::vector<ConflictReport::Rule> rules;
+
+		const auto to_rule = [](const ObjectData& a_data) {
+			return ConflictReport::Rule{ a_data.record, a_data.path, a_data.chance.chanceValue };
+		};
+
+		const auto add_map = [&](std::string_view a_section, const auto& a_map) {
+			if (a_token.stop_requested()) {
+				return;
+			}
+			for (const auto& [formID, dataVec] : a_map) {
+				if (dataVec.size() > 1) {
+					rules.clear();
+					std::ranges::transform(dataVec, std::back_inserter(rules), to_rule);
+					report.Add(a_section, GetProfileKey(formID), {}, rules);
+				}
+			}
+		};
+
+		// entries sharing an interned filter set pass or fail together, so only the last one of them can win
+		const auto add_conditional_map = [&](std::string_view a_section, const auto& a_map) {
+			if (a_token.stop_requested()) {
+				return;
+			}
+			std::vector<const ConditionFilters*> filterSets;
+			for (const auto& [formID, list] : a_map) {
+				filterSets.clear();
+				for (const auto& entry : list) {
+					if (std::ranges::find(filterSets, entry.filters) == filterSets.end()) {
+						filterSets.push_back(entry.filters);
+					}
+				}
+				for (const auto filters : filterSets) {
+					rules.clear();
+					for (const auto& entry : list) {
+						if (entry.filters == filters) {
+							std::ranges::transform(entry.data, std::back_inserter(rules), to_rule);
+						}
+					}
+					if (rules.size() > 1) {
+						report.Add(a_section, GetProfileKey(formID), filters->GetProfileKey(), rules);
+					}
+				}
+			}
+		};
+
+		// unparsed lines, only the chance field is read
+		const auto add_lazy = [&](std::string_view a_section, const auto& a_lazy, std::size_t a_chanceField) {
+			if (a_token.stop_requested()) {
+				return;
+			}
+			a_lazy.ForEachMultiLine([&](RE::FormID a_formID, const auto& a_lines) {
+				rules.clear();
+				for (const auto& [path, text] : a_lines) {
+					const auto   fields = string::split(std::string(text), "|");
+					const Chance chance(fields.size() > a_chanceField ? fields[a_chanceField] : std::string{});
+					rules.push_back({ text, path, chance.chanceValue });
+				}
+				report.Add(a_section, GetProfileKey(a_formID), {}, rules);
+			});
+		};
+
+		add_map("Forms"sv, swapForms);
+		add_lazy("Forms"sv, lazySwapForms, 3);
+		add_map("References"sv, swapRefs);
+		add_lazy("References"sv, lazySwapRefs, 3);
+		add_map("Properties"sv, refProperties);
+		add_lazy("Properties"sv, lazyRefProperties, 2);
+		add_conditional_map("Forms|conditional"sv, swapFormsConditional);
+		add_conditional_map("Properties|conditional"sv, refPropertiesConditional);
+
+		if (a_token.stop_requested()) {
+			return;
+		}
+
+		logger::info("{:*^30}", "CONFLICTS");
+		const auto conflicts = report.Write();
+		logger::info("Conflicts analyzed in {} ms", std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count());
+		spdlog::default_logger()->flush();
+
+		hasConflicts.store(conflicts > 0, std::memory_order_relaxed);
+		conflictsAnalyzed.store(true, std::memory_order_release);
+	}
+
+	void Manager::LoadINIs()
+	{
 		std::vector<std::string> configs = distribution::get_configs(R"(Data\)", "_SWAP"sv);
 
 		if (configs.empty()) {
-			logger::warn("No .ini files with _SWAP suffix were found within the Data folder, aborting...");
+			logger::warn("No .ini files with _SWAP suffix were found within the Data folder...");
 			return;
 		}
 
 		logger::info("{} matching inis found...", configs.size());
 
+		enum class SECTION
+		{
+			kNone,
+			kFormsConditional,
+			kPropertiesConditional,
+			kProperties,
+			kForms,
+			kReferences
+		};
+
+		std::size_t totalSize = 0;
+
+		const bool lazyRules = Settings::GetSingleton()->lazyRules;
+
 		for (auto& path : configs) {
 			logger::info("INI : {}", path);
 
-			CSimpleIniA ini;
-			ini.SetUnicode();
-			ini.SetMultiKey();
-			ini.SetAllowKeyOnly();
+			// an edited or replaced file changes size or write time
+			std::error_code ec;
+			const auto      size = std::filesystem::file_size(path, ec);
+			const auto      time = std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+			AddToFingerprint(path, size ^ static_cast<std::uint64_t>(time) * 0x9E3779B97F4A7C15ull);
 
-			if (const auto rc = ini.LoadFile(path.c_str()); rc < 0) {
+			ini::Reader reader;
+			if (!reader.Open(path)) {
 				logger::error("\tcouldn't read INI");
 				continue;
 			}
 
-			CSimpleIniA::TNamesDepend sections;
-			ini.GetAllSections(sections);
-			sections.sort(CSimpleIniA::Entry::LoadOrder());
+			totalSize += reader.size();
+
+			if (lazyRules) {
+				lazySwapForms.BeginFile(path);
+				lazySwapRefs.BeginFile(path);
+				lazyRefProperties.BeginFile(path);
+			}
+
+			LoadProfiler::ScopedTimer timer(LoadProfiler::STAGE::kReadINI, reader.size());
+
+			// repeated section headers are merged the way CSimpleIniA did, so rule order across them is unchanged
+			for (const auto& [name, keys] : reader.ReadSections()) {
+				const std::string       section(name);
+				auto                    sectionType = SECTION::kNone;
+				const ConditionFilters* processedConditions = nullptr;
 
-			for (auto& [_section, comment, keyOrder] : sections) {
-				std::string section = _section;
 				if (section.contains('|')) {
 					auto splitSection = string::split(section, "|");
-					auto conditions = string::split(splitSection[1], ",");  //[Forms|EditorID,EditorID2]
+					auto conditions = util::split_with_regex(splitSection[1], regex::string);  //[Forms|EditorID,EditorID2,radius(Worldspace,x,y,r)]
 
 					logger::info("\treading [{}] : {} conditions", splitSection[0], conditions.size());
 
-					ConditionFilters processedConditions(conditions);
+					processedConditions = ConditionFilterRegistry::GetSingleton()->Intern(ConditionFilters(conditions));
+					sectionType = splitSection[0] == "Forms" ? SECTION::kFormsConditional : SECTION::kPropertiesConditional;
+				} else {
+					logger::info("\treading [{}]", section);
 
-					CSimpleIniA::TNamesDepend values;
-					ini.GetAllKeys(section.c_str(), values);
-					values.sort(CSimpleIniA::Entry::LoadOrder());
+					if (section == "Transforms" || section == "Properties") {
+						sectionType = SECTION::kProperties;
+					} else {
+						sectionType = section == "Forms" ? SECTION::kForms : SECTION::kReferences;
+					}
+				}
 
-					if (!values.empty()) {
-						if (splitSection[0] == "Forms") {
-							logger::info("\t\t\t{} form swaps found", values.size());
-							for (const auto& key : values) {
-								SwapFormData::GetForms(path, key.pItem, [&](const RE::FormID a_baseID, const SwapFormData& a_swapData) {
-									swapFormsConditional[a_baseID].emplace_back(processedConditions, a_swapData);
-								});
-							}
+				for (const auto& keyView : keys) {
+					const std::string key(keyView);
+					switch (sectionType) {
+					case SECTION::kFormsConditional:
+						SwapFormData::GetForms(path, key, [&](const RE::FormID a_baseID, const SwapFormData& a_swapData) {
+							swapFormsConditional[a_baseID].emplace_back(processedConditions, a_swapData);
+						});
+						break;
+					case SECTION::kPropertiesConditional:
+						ObjectData::GetProperties(path, key, [&](const RE::FormID a_baseID, const ObjectData& a_objectData) {
+							refPropertiesConditional[a_baseID].emplace_back(processedConditions, a_objectData);
+						});
+						break;
+					case SECTION::kProperties:
+						if (lazyRules) {
+							lazyRefProperties.Add(key);
+							break;
+						}
+						ObjectData::GetProperties(path, key, [&](RE::FormID a_baseID, const ObjectData& a_objectData) {
+							refProperties[a_baseID].push_back(a_objectData);
+						});
+						break;
+					default:
+						if (sectionType == SECTION::kForms && WildcardIndex::IsWildcard(key)) {
+							wildcards.Add(path, key);
+						} else if (lazyRules) {
+							(sectionType == SECTION::kForms ? lazySwapForms : lazySwapRefs).Add(key);
 						} else {
-							logger::info("\t\t\t{} ref property overrides found", values.size());
-							for (const auto& key : values) {
-								ObjectData::GetProperties(path, key.pItem, [&](const RE::FormID a_baseID, const ObjectData& a_objectData) {
-									refPropertiesConditional[a_baseID].emplace_back(processedConditions, a_objectData);
-								});
-							}
+							auto& map = (sectionType == SECTION::kForms) ? swapForms : swapRefs;
+							SwapFormData::GetForms(path, key, [&](RE::FormID a_baseID, const SwapFormData& a_swapData) {
+								map[a_baseID].push_back(a_swapData);
+							});
 						}
+						break;
 					}
+				}
+
+				switch (sectionType) {
+				case SECTION::kForms:
+				case SECTION::kFormsConditional:
+					logger::info("\t\t\t{} form swaps found", keys.size());
+					break;
+				case SECTION::kReferences:
+					logger::info("\t\t\t{} swaps found", keys.size());
+					break;
+				default:
+					logger::info("\t\t\t{} ref property overrides found", keys.size());
+					break;
+				}
+			}
+
+			LoadErrors::GetSingleton()->LogSummary();
+		}
+
+		logger::info("{:.2f} MB of configs read", static_cast<double>(totalSize) / (1024.0 * 1024.0));
+	}
+
+	void Manager::AddToFingerprint(std::string_view a_str, std::uint64_t a_value)
+	{
+		// FNV-1a, stable across sessions unlike std::hash
+		std::uint64_t hash = 0xCBF29CE484222325ull;
+		for (const auto c : a_str) {
+			hash = (hash ^ static_cast<std::uint8_t>(c)) * 0x100000001B3ull;
+		}
+
+		const auto combine = [&](std::uint64_t a_hash) {
+			rulesFingerprint ^= a_hash + 0x9E3779B97F4A7C15ull + (rulesFingerprint << 6) + (rulesFingerprint >> 2);
+		};
+		combine(hash);
+		combine(a_value);
+	}
+
+	void Manager::ApplyRuleBatch(RuleBatch& a_batch)
+	{
+		logger::info("API : {} ({} rules, priority {})", a_batch.source, a_batch.count, a_batch.priority);
+		AddToFingerprint(a_batch.source, (static_cast<std::uint64_t>(a_batch.count) << 32) | static_cast<std::uint32_t>(a_batch.priority));
+
+		const auto merge = [](auto& a_map, auto& a_batchMap) {
+			a_map.reserve(a_map.size() + a_batchMap.size());
+			for (auto& [formID, batchVec] : a_batchMap) {
+				auto& vec = a_map[formID];
+				vec.reserve(vec.size() + batchVec.size());
+				std::ranges::move(batchVec, std::back_inserter(vec));
+			}
+		};
+
+		// indexed INI lines of the batch's keys are loaded first, so they stay between lower and higher priority batches
+		const auto load_lazy = [](auto& a_map, const auto& a_batchMap, auto& a_lazy) {
+			for (const auto formID : a_batchMap | std::views::keys) {
+				if (auto rules = a_lazy.extract(formID); !rules.empty()) {
+					std::ranges::move(rules, std::back_inserter(a_map[formID]));
+				}
+			}
+		};
+
+		load_lazy(swapRefs, a_batch.swapRefs, lazySwapRefs);
+		load_lazy(swapForms, a_batch.swapForms, lazySwapForms);
+		load_lazy(refProperties, a_batch.refProperties, lazyRefProperties);
+
+		merge(swapRefs, a_batch.swapRefs);
+		merge(swapFormsConditional, a_batch.swapFormsConditional);
+		merge(swapForms, a_batch.swapForms);
+		merge(refProperties, a_batch.refProperties);
+		merge(refPropertiesConditional, a_batch.refPropertiesConditional);
+	}
+
+	bool Manager::RegisterRules(std::string_view a_source, std::span<const BOSAPI::Rule> a_rules, std::int32_t a_priority)
+	{
+		std::scoped_lock lock(pendingLock);
+
+		if (formsLoaded) {
+			logger::error("API : {} submitted {} rules after swaps were loaded, ignoring", a_source, a_rules.size());
+			return false;
+		}
+
+		RuleBatch batch{ std::string(a_source), a_priority };
+
+		constexpr auto to_span = [](const std::uint32_t* a_ids, std::uint32_t a_count) {
+			return a_ids ? std::span(a_ids, a_count) : std::span<const std::uint32_t>{};
+		};
+
+		constexpr auto to_range = [](const BOSAPI::FloatRange& a_range) {
+			FloatRange range;
+			range.min = a_range.min;
+			range.max = a_range.max;
+			return range;
+		};
+
+		const auto to_point3 = [&](const BOSAPI::Point3Range& a_range, bool a_convertToRad) {
+			Point3Range range;
+			range.relative = a_range.relative;
+			range.x = to_range(a_range.x);
+			range.y = to_range(a_range.y);
+			range.z = to_range(a_range.z);
+			if (a_convertToRad) {
+				range.x.convert_to_radians();
+				range.y.convert_to_radians();
+				range.z.convert_to_radians();
+			}
+			return range;
+		};
+
+		for (const auto& rule : a_rules) {
+			if (rule.baseID == 0) {
+				logger::error("\t\t\t\tfail : [{}] (BASE formID is 0)", a_source);
+				continue;
+			}
+
+			if (std::to_underlying(rule.chanceType) > std::to_underlying(BOSAPI::ChanceType::kLocationHash)) {
+				logger::error("\t\t\t\tfail : [0x{:X}] (invalid chance type {})", rule.baseID, std::to_underlying(rule.chanceType));
+				continue;
+			}
+
+			const auto& props = rule.properties;
+
+			std::optional<Point3Range> location{ std::nullopt };
+			std::optional<Point3Range> rotation{ std::nullopt };
+			std::optional<ScaleRange>  refScale{ std::nullopt };
+			if (props.flags & BOSAPI::Properties::kLocation) {
+				location = to_point3(props.location, false);
+			}
+			if (props.flags & BOSAPI::Properties::kRotation) {
+				rotation = to_point3(props.rotation, true);
+			}
+			if (props.flags & BOSAPI::Properties::kScale) {
+				refScale = ScaleRange();
+				refScale->absolute = props.scaleAbsolute;
+				refScale->value = to_range(props.scale);
+			}
+
+			const ObjectProperties properties(location, rotation, refScale, props.recordFlagsSet, props.recordFlagsUnset);
+			const Chance           chance(static_cast<CHANCE_TYPE>(rule.chanceType), rule.chance);
+
+			ConditionFilters filters;
+			for (const auto formID : to_span(rule.matchFilters, rule.matchCount)) {
+				filters.MATCH.emplace_back(formID);
+			}
+			for (const auto formID : to_span(rule.notFilters, rule.notCount)) {
+				filters.NOT.emplace_back(formID);
+			}
+			const bool conditional = !filters.MATCH.empty() || !filters.NOT.empty();
+
+			if (rule.type == BOSAPI::RuleType::kProperties) {
+				if (!properties.IsValid()) {
+					logger::error("\t\t\t\tfail : [0x{:X}] (no properties set)", rule.baseID);
+					continue;
+				}
+				ObjectData objectData(properties, chance, std::format("0x{:X}|properties", rule.baseID), batch.source);
+				if (conditional) {
+					batch.refPropertiesConditional[rule.baseID].emplace_back(filters, objectData);
 				} else {
-					logger::info("\treading [{}]", section);
+					batch.refProperties[rule.baseID].push_back(std::move(objectData));
+				}
+				batch.count++;
+				continue;
+			}
 
-					CSimpleIniA::TNamesDepend values;
-					ini.GetAllKeys(section.c_str(), values);
-					values.sort(CSimpleIniA::Entry::LoadOrder());
-
-					if (!values.empty()) {
-						if (section == "Transforms" || section == "Properties") {
-							logger::info("\t\t\t{} ref property overrides found", values.size());
-							for (const auto& key : values) {
-								ObjectData::GetProperties(path, key.pItem, [&](RE::FormID a_baseID, const ObjectData& a_objectData) {
-									refProperties[a_baseID].push_back(a_objectData);
-								});
-							}
-						} else {
-							logger::info("\t\t\t{} swaps found", values.size());
-							auto& map = (section == "Forms") ? swapForms : swapRefs;
-							for (const auto& key : values) {
-								SwapFormData::GetForms(path, key.pItem, [&](RE::FormID a_baseID, const SwapFormData& a_swapData) {
-									map[a_baseID].push_back(a_swapData);
-								});
-							}
-						}
+			const auto swapIDs = to_span(rule.swapIDs, rule.swapCount);
+
+			FormIDOrSet swapFormID{ static_cast<RE::FormID>(0) };
+			if (swapIDs.size() == 1) {
+				swapFormID = swapIDs.front();
+			} else if (swapIDs.size() > 1) {
+				FormIDSet set;
+				set.reserve(swapIDs.size());
+				for (const auto formID : swapIDs) {
+					if (formID != 0) {
+						set.emplace(formID);
 					}
 				}
+				swapFormID = std::move(set);
 			}
+
+			const bool swapEmpty = std::visit(overload{
+												  [](RE::FormID a_formID) { return a_formID == 0; },
+												  [](const FormIDSet& a_set) { return a_set.empty(); } },
+				swapFormID);
+			if (swapEmpty) {
+				logger::error("\t\t\t\tfail : [0x{:X}] (SWAP formID not found)", rule.baseID);
+				continue;
+			}
+
+			std::string swapStr;
+			for (const auto formID : swapIDs) {
+				swapStr += swapStr.empty() ? std::format("0x{:X}", formID) : std::format(",0x{:X}", formID);
+			}
+
+			SwapFormData swapData(std::move(swapFormID), ObjectData(properties, chance, std::format("0x{:X}|{}", rule.baseID, swapStr), batch.source));
+			if (rule.type == BOSAPI::RuleType::kReference) {
+				if (conditional) {
+					logger::error("\t\t\t\tfail : [0x{:X}] (reference swaps can't be conditional)", rule.baseID);
+					continue;
+				}
+				batch.swapRefs[rule.baseID].push_back(std::move(swapData));
+			} else if (conditional) {
+				batch.swapFormsConditional[rule.baseID].emplace_back(filters, swapData);
+			} else {
+				batch.swapForms[rule.baseID].push_back(std::move(swapData));
+			}
+			batch.count++;
 		}
 
-		logger::info("{:*^30}", "RESULT");
+		if (batch.count == 0) {
+			return false;
+		}
 
-		logger::info("{} form-form swaps", swapForms.size());
-		logger::info("{} conditional form swaps", swapFormsConditional.size());
-		logger::info("{} ref-form swaps", swapRefs.size());
-		logger::info("{} ref property overrides", refProperties.size());
-		logger::info("{} conditional ref property overrides", refPropertiesConditional.size());
+		pendingBatches.push_back(std::move(batch));
+		return true;
+	}
 
-		logger::info("{:*^30}", "CONFLICTS");
+	void Manager::ResolveSwapForms()
+	{
+		std::size_t rejected = 0;
+
+		const auto resolve = [&](SwapFormDataVec& a_swapDataVec) {
+			rejected += std::erase_if(a_swapDataVec, [](SwapFormData& a_swapData) { return !a_swapData.ResolveSwapObjects(); });
+		};
+
+		for (const auto& map : { &swapRefs, &swapForms }) {
+			std::vector<RE::FormID> emptyIDs;
+			for (auto& [baseID, swapDataVec] : *map) {
+				resolve(swapDataVec);
+				if (swapDataVec.empty()) {
+					emptyIDs.push_back(baseID);
+				}
+			}
+			for (const auto& baseID : emptyIDs) {
+				map->erase(baseID);
+			}
+		}
+		for (auto& conditionalVec : swapFormsConditional | std::views::values) {
+			for (auto& conditionalData : conditionalVec) {
+				resolve(conditionalData.data);
+			}
+		}
+		rejected += wildcards.ResolveSwapObjects();
+
+		// copies of lazy keys, their rejections are counted when the lazy key is compiled
+		for (const auto& map : { &referenceSwapRefs, &referenceSwapForms }) {
+			std::erase_if(*map, [](auto& a_entry) {
+				std::erase_if(a_entry.second, [](SwapFormData& a_swapData) { return !a_swapData.ResolveSwapObjects(); });
+				return a_entry.second.empty();
+			});
+		}
+
+		LoadErrors::GetSingleton()->LogSummary();
+
+		if (rejected > 0) {
+			logger::warn("{} swaps rejected, no valid swap forms left", rejected);
+		}
+	}
+
+	void Manager::BuildLeveledListCache()
+	{
+		const auto add_list = [this](const RE::TESBoundObject* a_object) {
+			const auto list = a_object->As<RE::TESLevItem>();
+			if (!list || flatLeveledLists.contains(list->GetFormID())) {
+				return;
+			}
+			if (FlatLeveledList flatList(list); !flatList.empty()) {
+				flatLeveledLists.emplace(list->GetFormID(), std::move(flatList));
+			}
+		};
+
+		const auto add_lists = [&](const SwapFormData& a_swapData) {
+			std::ranges::for_each(a_swapData.swapObjects, add_list);
+		};
+
+		for (const auto& map : { &swapRefs, &swapForms }) {
+			for (const auto& swapDataVec : *map | std::views::values) {
+				std::ranges::for_each(swapDataVec, add_lists);
+			}
+		}
+		for (const auto& conditionalVec : swapFormsConditional | std::views::values) {
+			for (const auto& conditionalData : conditionalVec) {
+				std::ranges::for_each(conditionalData.data, add_lists);
+			}
+		}
+		wildcards.ForEachRule(add_lists);
+	}
+
+	void Manager::FinishLazyRules()
+	{
+		if (!Settings::GetSingleton()->lazyRules) {
+			return;
+		}
+
+		std::size_t loaded = 0;
+
+		// keys API batches already use must keep their order, hook keys need their swap targets in BuildHookCategories
+		const auto load_eager = [&](auto& a_map, auto& a_lazy) {
+			for (const auto formID : a_lazy.keys()) {
+				const auto form = RE::TESForm::GetFormByID(formID);
+				if (!a_map.contains(formID) && (!form || GetHookType(form) == HOOK_TYPE::kReference)) {
+					continue;
+				}
+				if (auto rules = a_lazy.extract(formID); !rules.empty()) {
+					loaded += rules.size();
+					std::ranges::move(rules, std::back_inserter(a_map[formID]));
+				}
+			}
+			a_lazy.shrink_to_fit();
+		};
+
+		load_eager(swapRefs, lazySwapRefs);
+		load_eager(swapForms, lazySwapForms);
+		load_eager(refProperties, lazyRefProperties);
+
+		// what ResolveSwapForms and BuildLeveledListCache do for loaded rules
+		const auto finalize_swaps = [this](SwapFormDataVec& a_swapDataVec) {
+			std::erase_if(a_swapDataVec, [](SwapFormData& a_swapData) { return !a_swapData.ResolveSwapObjects(); });
+			AddLazyLeveledLists(a_swapDataVec);
+		};
+		lazySwapRefs.SetFinalize(finalize_swaps);
+		lazySwapForms.SetFinalize(finalize_swaps);
+
+		// the reference engine doesn't compile on lookup, its swap forms are resolved with the loaded rules
+		if (ShadowEval::GetSingleton()->IsEnabled()) {
+			const auto copy_rules = [](const auto& a_lazy, auto& a_map) {
+				a_lazy.ForEachParsed([&](RE::FormID a_formID, auto&& a_rules) {
+					if (!a_rules.empty()) {
+						a_map.emplace(a_formID, std::move(a_rules));
+					}
+				});
+			};
+			copy_rules(lazySwapRefs, referenceSwapRefs);
+			copy_rules(lazySwapForms, referenceSwapForms);
+			copy_rules(lazyRefProperties, referenceRefProperties);
+		}
 
-		const auto log_conflicts = [&]<typename T>(std::string_view a_type, const FormIDMap<T>& a_map) {
+		logger::info("lazy rules : {} keys ({} lines) indexed, {} rules loaded now",
+			lazySwapRefs.size() + lazySwapForms.size() + lazyRefProperties.size(),
+			lazySwapRefs.GetLineCount() + lazySwapForms.GetLineCount() + lazyRefProperties.GetLineCount(),
+			loaded);
+	}
+
+	void Manager::AddLazyLeveledLists(const SwapFormDataVec& a_swapDataVec)
+	{
+		for (const auto& swapData : a_swapDataVec) {
+			for (const auto object : swapData.swapObjects) {
+				const auto list = object->As<RE::TESLevItem>();
+				if (!list || flatLeveledLists.contains(list->GetFormID())) {
+					continue;
+				}
+				const auto listID = list->GetFormID();
+				lazyLeveledLists.write(listID, [&](auto& a_lists) {
+					if (a_lists.contains(listID)) {
+						return;
+					}
+					if (FlatLeveledList flatList(list); !flatList.empty()) {
+						a_lists.emplace(listID, std::move(flatList));
+					}
+				});
+			}
+		}
+	}
+
+	std::optional<RE::TESBoundObject*> Manager::PickFlatLeveledList(const RE::TESLevItem* a_list, const RefContext& a_context) const
+	{
+		const auto listID = a_list->GetFormID();
+
+		// level brackets are baked in, so player level changes don't require a rebuild
+		// the list is mixed into the ref seed, which the chance roll and swap set pick already use as is
+		const auto pick = [&](const FlatLeveledList& a_flatList) -> std::optional<RE::TESBoundObject*> {
+			if (!a_flatList.IsValid(a_list)) {
+				return std::nullopt;
+			}
+			const auto playerLevel = static_cast<std::uint16_t>(RE::PlayerCharacter::GetSingleton()->GetLevel());
+			BOS_RNG    rng(CHANCE_TYPE::kRefHash, a_context);
+			rng.seed = hash::szudzik_pair(a_context.GetRefID(), listID);
+			return a_flatList.Pick(playerLevel, rng);
+		};
+
+		if (const auto it = flatLeveledLists.find(listID); it != flatLeveledLists.end()) {
+			return pick(it->second);
+		}
+		return lazyLeveledLists.read(listID, [&](const auto& a_lists) -> std::optional<RE::TESBoundObject*> {
+			const auto it = a_lists.find(listID);
+			return it != a_lists.end() ? pick(it->second) : std::nullopt;
+		});
+	}
+
+	void Manager::CompileConditionalLists()
+	{
+		std::size_t filters = 0;
+		std::size_t atoms = 0;
+
+		const auto profile = FilterProfile::GetSingleton();
+		const auto registry = ConditionFilterRegistry::GetSingleton();
+
+		if (!swapFormsConditional.empty() || !refPropertiesConditional.empty()) {
+			profile->Load();
+			registry->OrderAtoms();
+		}
+
+		const auto compile = [&](auto& a_map) {
+			for (auto& [baseID, list] : a_map) {
+				list.Compile(baseID);
+				filters += list.GetFilterCount();
+				atoms += list.GetAtomCount();
+			}
+		};
+
+		compile(swapFormsConditional);
+		compile(refPropertiesConditional);
+
+		registry->AssignIDs();
+		profile->Start();
+
+		if (filters > 0) {
+			logger::info("{} condition headers share {} distinct filter sets", registry->GetInternCount(), registry->size());
+			logger::info("{} conditional filters compiled into {} distinct atoms", filters, atoms);
+		}
+
+		const auto log_partitions = [](std::string_view a_name, const auto& a_map) {
 			if (a_map.empty()) {
 				return;
 			}
-			logger::info("[{}]", a_type);
-			bool conflicts = false;
-			for (auto& [baseID, swapDataVec] : a_map) {
-				if (swapDataVec.size() > 1) {
-					const auto& winningRecord = swapDataVec.back();
-					if (winningRecord.chance.chanceValue != 100) {  //ignore if winning record is randomized
+			std::size_t partitioned = 0;
+			double      before = 0.0;
+			double      after = 0.0;
+			for (const auto& list : a_map | std::views::values) {
+				partitioned += list.GetPartitionCount() > 0;
+				before += static_cast<double>(list.size());
+				after += list.GetAverageCandidates();
+			}
+			const auto lists = static_cast<double>(a_map.size());
+			logger::info("{} : {} of {} lists partitioned by worldspace, {:.2f} candidates per search before, {:.2f} after", a_name, partitioned, a_map.size(), before / lists, after / lists);
+		};
+
+		log_partitions("swapFormsConditional"sv, swapFormsConditional);
+		log_partitions("refPropertiesConditional"sv, refPropertiesConditional);
+
+		// dead config, from the profile of earlier sessions
+		std::size_t unmatched = 0;
+
+		const auto log_unmatched = [&](const auto& a_map) {
+			for (const auto& list : a_map | std::views::values) {
+				const auto searches = profile->GetProfile(list.GetListProfileKey());
+				if (!searches || searches->evaluations == 0) {
+					continue;
+				}
+				for (std::size_t i = 0; i < list.size(); ++i) {
+					const auto checks = profile->GetProfile(list.GetEntryProfileKey(i));
+					if (checks && checks->hits > 0) {
 						continue;
 					}
-					conflicts = true;
-					auto winningForm = string::split(winningRecord.record, "|");
-					logger::warn("\t{}", winningForm[0]);
-					logger::warn("\t\twinning swap : {} ({})", winningForm[1], swapDataVec.back().path);
-					logger::warn("\t\t{} conflicts", swapDataVec.size() - 1);
-					for (auto it = swapDataVec.rbegin() + 1; it != swapDataVec.rend(); ++it) {
-						auto losingRecord = it->record.substr(it->record.find('|') + 1);
-						logger::warn("\t\t\t{} ({})", losingRecord, it->path);
+					if (unmatched++ == 0) {
+						logger::info("{:*^30}", "UNMATCHED RULES");
+					}
+					const auto& entry = *std::next(list.begin(), i);
+					const auto  record = entry.data.empty() ? std::string{} : entry.data.front().record;
+					const auto  path = entry.data.empty() ? std::string{} : entry.data.front().path;
+					if (!checks || checks->evaluations == 0) {
+						logger::info("\t[{}] {} : shadowed by later rules or outside the searched worldspaces in {} lookups", path, record, searches->evaluations);
+					} else {
+						logger::info("\t[{}] {} : filters never passed in {} checks", path, record, checks->evaluations);
 					}
 				}
 			}
-			if (!conflicts) {
-				logger::info("\tNo conflicts found");
-			} else {
-				hasConflicts = true;
+		};
+
+		log_unmatched(swapFormsConditional);
+		log_unmatched(refPropertiesConditional);
+	}
+
+	void Manager::BuildHookCategories()
+	{
+		for (auto& keys : hookKeys) {
+			keys.clear();
+		}
+
+		hookWildcards[std::to_underlying(HOOK_TYPE::kProjectile)] = wildcards.HasFormType(RE::ENUM_FORM_ID::kPROJ);
+		hookWildcards[std::to_underlying(HOOK_TYPE::kHazard)] = wildcards.HasFormType(RE::ENUM_FORM_ID::kHAZD);
+
+		const auto add_key = [&](RE::FormID a_formID) {
+			const auto form = RE::TESForm::GetFormByID(a_formID);
+			if (!form) {
+				return;
+			}
+			const auto type = GetHookType(form);
+			for (const auto hookType : { HOOK_TYPE::kProjectile, HOOK_TYPE::kHazard }) {
+				if (type == hookType || type == HOOK_TYPE::kTotal) {
+					hookKeys[std::to_underlying(hookType)].insert(a_formID);
+				}
 			}
 		};
 
-		log_conflicts("Forms"sv, swapForms);
-		log_conflicts("References"sv, swapRefs);
-		log_conflicts("Properties"sv, refProperties);
+		for (const auto& map : { &swapRefs, &swapForms }) {
+			for (const auto formID : *map | std::views::keys) {
+				add_key(formID);
+			}
+		}
+		for (const auto formID : swapFormsConditional | std::views::keys) {
+			add_key(formID);
+		}
+		for (const auto formID : refProperties | std::views::keys) {
+			add_key(formID);
+		}
+		for (const auto formID : refPropertiesConditional | std::views::keys) {
+			add_key(formID);
+		}
 
-		logger::info("{:*^30}", "END");
+		logger::info("{} projectile rule keys, {} hazard rule keys", hookKeys[std::to_underlying(HOOK_TYPE::kProjectile)].size(), hookKeys[std::to_underlying(HOOK_TYPE::kHazard)].size());
+	}
+
+	HOOK_TYPE Manager::GetHookType(const RE::TESForm* a_form)
+	{
+		if (const auto ref = a_form->As<RE::TESObjectREFR>()) {
+			a_form = ref->GetObjectReference();
+		}
+		if (!a_form) {
+			return HOOK_TYPE::kReference;
+		}
+		switch (a_form->GetFormType()) {
+		case RE::ENUM_FORM_ID::kPROJ:
+			return HOOK_TYPE::kProjectile;
+		case RE::ENUM_FORM_ID::kHAZD:
+			return HOOK_TYPE::kHazard;
+		case RE::ENUM_FORM_ID::kMSWP:
+			return HOOK_TYPE::kTotal;  // material swaps are shared by every hook
+		default:
+			return HOOK_TYPE::kReference;
+		}
+	}
+
+	bool Manager::HasHookRules(HOOK_TYPE a_type, const RE::TESObjectREFR* a_ref) const
+	{
+		if (a_type == HOOK_TYPE::kReference) {
+			return true;
+		}
+
+		if (hookWildcards[std::to_underlying(a_type)]) {
+			return true;
+		}
+
+		const auto& keys = hookKeys[std::to_underlying(a_type)];
+		if (keys.empty()) {
+			return false;
+		}
+
+		if (keys.contains(a_ref->GetFormID())) {
+			return true;
+		}
+
+		const auto base = a_ref->GetObjectReference();
+		if (!base) {
+			return false;
+		}
+		if (keys.contains(base->GetFormID())) {
+			return true;
+		}
+
+		const auto materialSwap = base->As<RE::BGSModelMaterialSwap>();
+		return materialSwap && materialSwap->swapForm && keys.contains(materialSwap->swapForm->GetFormID());
+	}
+
+	void Manager::LogMemoryReport() const
+	{
+		MemoryReport report;
+
+		const auto object_usage = [](const ObjectData& a_data) {
+			return MemoryReport::Usage{ 1, sizeof(ObjectData), MemoryReport::string_bytes(a_data.record) + MemoryReport::string_bytes(a_data.path) };
+		};
+		const auto swap_usage = [&](const SwapFormData& a_data) {
+			auto usage = object_usage(a_data);
+			usage.dataBytes = sizeof(SwapFormData) + MemoryReport::vector_bytes(a_data.swapObjects);
+			if (const auto formIDs = std::get_if<FormIDSet>(&a_data.formIDSet)) {
+				usage.dataBytes += MemoryReport::table_bytes(*formIDs);
+			}
+			return usage;
+		};
+
+		// vector slack is counted with the table
+		const auto add_map = [&](std::string_view a_name, const auto& a_map, const auto& a_usage) {
+			std::size_t tableBytes = MemoryReport::table_bytes(a_map);
+			for (const auto& dataVec : a_map | std::views::values) {
+				tableBytes += (dataVec.capacity() - dataVec.size()) * sizeof(typename std::decay_t<decltype(dataVec)>::value_type);
+				for (const auto& data : dataVec) {
+					report.AddRule(a_name, data.path, a_usage(data));
+				}
+			}
+			report.AddTable(a_name, a_map.size(), tableBytes, a_map.load_factor());
+		};
+		const auto add_conditional_map = [&](std::string_view a_name, const auto& a_map, const auto& a_usage) {
+			std::size_t tableBytes = MemoryReport::table_bytes(a_map);
+			for (const auto& list : a_map | std::views::values) {
+				tableBytes += list.GetHeapBytes();
+				for (const auto& conditionalData : list) {
+					for (const auto& data : conditionalData.data) {
+						report.AddRule(a_name, data.path, a_usage(data));
+					}
+				}
+			}
+			report.AddTable(a_name, a_map.size(), tableBytes, a_map.load_factor());
+		};
+		const auto add_sharded = [&](std::string_view a_name, const auto& a_table) {
+			std::size_t keys = 0;
+			std::size_t tableBytes = 0;
+			a_table.for_each_shard([&](const auto& a_shard) {
+				keys += a_shard.size();
+				tableBytes += MemoryReport::table_bytes(a_shard);
+			});
+			report.AddShared(a_name, { keys, tableBytes, 0 });
+		};
+
+		add_map("swapForms"sv, swapForms, swap_usage);
+		add_map("swapRefs"sv, swapRefs, swap_usage);
+		add_conditional_map("swapFormsConditional"sv, swapFormsConditional, swap_usage);
+		wildcards.ForEachRule([&](const SwapFormData& a_swapData) {
+			report.AddRule("wildcards"sv, a_swapData.path, swap_usage(a_swapData));
+		});
+		add_map("refProperties"sv, refProperties, object_usage);
+		if (Settings::GetSingleton()->lazyRules && ShadowEval::GetSingleton()->IsEnabled()) {
+			add_map("referenceSwapRefs"sv, referenceSwapRefs, swap_usage);
+			add_map("referenceSwapForms"sv, referenceSwapForms, swap_usage);
+			add_map("referenceRefProperties"sv, referenceRefProperties, object_usage);
+		}
+		add_conditional_map("refPropertiesConditional"sv, refPropertiesConditional, object_usage);
+
+		// index and line text as the table, keys compiled so far as rules
+		const auto add_lazy = [&](std::string_view a_name, const auto& a_lazy, const auto& a_usage) {
+			if (a_lazy.empty()) {
+				return;
+			}
+			a_lazy.ForEachCompiled([&](const auto& a_data) { report.AddRule(a_name, a_data.path, a_usage(a_data)); });
+			report.AddTable(a_name, a_lazy.size(), a_lazy.GetHeapBytes(), 0.0f);
+			logger::info("{} : {} of {} keys compiled", a_name, a_lazy.GetCompiledCount(), a_lazy.size());
+		};
+		add_lazy("lazySwapForms"sv, lazySwapForms, swap_usage);
+		add_lazy("lazySwapRefs"sv, lazySwapRefs, swap_usage);
+		add_lazy("lazyRefProperties"sv, lazyRefProperties, object_usage);
+
+		const auto registry = ConditionFilterRegistry::GetSingleton();
+		report.AddShared("condition filter sets"sv, { registry->size(), registry->GetHeapBytes(), 0 });
+		add_sharded("swapDecisions"sv, swapDecisions);
+		add_sharded("swappedLeveledItemRefs"sv, swappedLeveledItemRefs);
+		if (lazyLeveledLists.size() > 0) {
+			add_sharded("lazyLeveledLists"sv, lazyLeveledLists);
+		}
+
+		report.Log();
 	}
 
 	void Manager::PrintConflicts() const
 	{
-		if (const auto console = RE::ConsoleLog::GetSingleton(); hasConflicts) {
-			console->PrintLine(std::format("[BOS] Conflicts found, check po3_BaseObjectSwapper.log in {} for more info\n", logger::log_directory()->string()).c_str());
+		// analysis runs in the background, printed once it is done
+		if (!conflictsAnalyzed.load(std::memory_order_acquire) || !hasConflicts.load(std::memory_order_relaxed) || conflictsPrinted.exchange(true)) {
+			return;
+		}
+		if (const auto console = RE::ConsoleLog::GetSingleton()) {
+			console->PrintLine(std::format("[BOS] Conflicts found, check po3_BaseObjectSwapper.log and {}_Conflicts.csv in {} for more info\n", Version::PROJECT, logger::log_directory()->string()).c_str());
 		}
 	}
 
-	SwapFormResult Manager::GetSwapFormConditional(const RE::TESObjectREFR* a_ref, const RE::TESForm* a_base, const RE::BGSMaterialSwap* a_materialSwap)
+	template <ENGINE Engine, class T, class Explain>
+	const ConditionalData<T>* Manager::FindConditional(const ConditionalList<T>& a_list, const ConditionalInput& a_input, Explain& a_explain)
 	{
-		auto it = swapFormsConditional.find(a_base->GetFormID());
+		if constexpr (Engine == ENGINE::kReference) {
+			return a_list.FindReference(a_input, a_explain);
+		} else {
+			return a_list.Find(a_input, a_explain);
+		}
+	}
+
+	template <ENGINE Engine, class Explain>
+	SwapFormResult Manager::GetSwapFormConditional(const RefContext& a_context, const RE::BGSMaterialSwap* a_materialSwap, Explain& a_explain)
+	{
+		auto it = swapFormsConditional.find(a_context.GetBase()->GetFormID());
 		if (it == swapFormsConditional.end() && a_materialSwap) {
 			it = swapFormsConditional.find(a_materialSwap->GetFormID());
 		}
 
 		if (it != swapFormsConditional.end()) {
-			const ConditionalInput input(a_ref, a_base);
+			const ConditionalInput input(a_context);
 
-			auto result = std::ranges::find_if(it->second | std::views::reverse, [&](auto& conditionalData) { return input.IsValid(conditionalData.filters); });
-
-			if (result != it->second.rend()) {
+			if (const auto result = FindConditional<Engine>(it->second, input, a_explain)) {
 				for (auto& swapData : result->data | std::ranges::views::reverse) {
-					if (auto swapObject = swapData.GetSwapBase(a_ref)) {
+					if (auto swapObject = swapData.GetSwapBase(a_context, a_explain)) {
+						if constexpr (Explain::enabled) {
+							a_explain.Log("winner {} ({})", swapData.record, swapData.path);
+						}
 						return { swapObject, swapData.properties };
 					}
 				}
@@ -177,21 +972,23 @@ namespace FormSwap
 		return { nullptr, std::nullopt };
 	}
 
-	std::optional<ObjectProperties> Manager::GetObjectPropertiesConditional(const RE::TESObjectREFR* a_ref, const RE::TESForm* a_base, const RE::BGSMaterialSwap* a_materialSwap)
+	template <ENGINE Engine, class Explain>
+	std::optional<ObjectProperties> Manager::GetObjectPropertiesConditional(const RefContext& a_context, const RE::BGSMaterialSwap* a_materialSwap, Explain& a_explain)
 	{
-		auto it = refPropertiesConditional.find(a_base->GetFormID());
+		auto it = refPropertiesConditional.find(a_context.GetBase()->GetFormID());
 		if (it == refPropertiesConditional.end() && a_materialSwap) {
 			it = refPropertiesConditional.find(a_materialSwap->GetFormID());
 		}
 
 		if (it != refPropertiesConditional.end()) {
-			const ConditionalInput input(a_ref, a_base);
-
-			auto result = std::ranges::find_if(it->second | std::views::reverse, [&](auto& conditionalData) { return input.IsValid(conditionalData.filters); });
+			const ConditionalInput input(a_context);
 
-			if (result != it->second.rend()) {
+			if (const auto result = FindConditional<Engine>(it->second, input, a_explain)) {
 				for (auto& objectData : result->data | std::ranges::views::reverse) {
-					if (objectData.HasValidProperties(a_ref)) {
+					if (objectData.HasValidProperties(a_context, a_explain)) {
+						if constexpr (Explain::enabled) {
+							a_explain.Log("winner {} ({})", objectData.record, objectData.path);
+						}
 						return objectData.properties;
 					}
 				}
@@ -203,27 +1000,206 @@ namespace FormSwap
 
 	void Manager::InsertLeveledItemRef(const RE::TESObjectREFR* a_refr)
 	{
-		swappedLeveledItemRefs.insert(a_refr->GetFormID());
+		const auto refID = a_refr->GetFormID();
+		swappedLeveledItemRefs.write(refID, [&](auto& a_refs) { a_refs.insert(refID); });
 	}
 
 	bool Manager::IsLeveledItemRefSwapped(const RE::TESObjectREFR* a_refr) const
 	{
-		return swappedLeveledItemRefs.contains(a_refr->GetFormID());
+		const auto refID = a_refr->GetFormID();
+		return swappedLeveledItemRefs.read(refID, [&](const auto& a_refs) { return a_refs.contains(refID); });
+	}
+
+	void Manager::InsertSwapDecision(const RefContext& a_context, const SwapFormResult& a_swapData)
+	{
+		if (a_context.IsCreated()) {
+			return;
+		}
+
+		const auto refID = a_context.GetRefID();
+		swapDecisions.write(refID, [&](auto& a_decisions) {
+			a_decisions.insert_or_assign(refID, SwapDecision{ a_context.GetBase()->GetFormID(), a_swapData.first, a_swapData.second });
+		});
+	}
+
+	std::optional<SwapFormResult> Manager::GetSwapDecision(const RefContext& a_context) const
+	{
+		if (a_context.IsCreated()) {
+			return std::nullopt;
+		}
+
+		const auto refID = a_context.GetRefID();
+		const auto baseID = a_context.GetBase()->GetFormID();
+		return swapDecisions.read(refID, [&](const auto& a_decisions) -> std::optional<SwapFormResult> {
+			if (const auto it = a_decisions.find(refID); it != a_decisions.end() && it->second.baseID == baseID) {
+				return SwapFormResult{ it->second.swapBase, it->second.properties };
+			}
+			return std::nullopt;
+		});
+	}
+
+	std::optional<SwapDecision> Manager::FindSwapDecision(RE::FormID a_refID) const
+	{
+		return swapDecisions.read(a_refID, [&](const auto& a_decisions) -> std::optional<SwapDecision> {
+			if (const auto it = a_decisions.find(a_refID); it != a_decisions.end()) {
+				return it->second;
+			}
+			return std::nullopt;
+		});
+	}
+
+	std::vector<std::pair<RE::FormID, SwapDecision>> Manager::GetSwapDecisions() const
+	{
+		std::vector<std::pair<RE::FormID, SwapDecision>> result;
+		swapDecisions.for_each_shard([&](const auto& a_decisions) {
+			result.insert(result.end(), a_decisions.begin(), a_decisions.end());
+		});
+		std::ranges::sort(result, {}, [](const auto& a_decision) { return a_decision.first; });
+		return result;
+	}
+
+	std::vector<RE::FormID> Manager::GetLeveledItemRefs() const
+	{
+		std::vector<RE::FormID> result;
+		swappedLeveledItemRefs.for_each_shard([&](const auto& a_refs) {
+			result.insert(result.end(), a_refs.begin(), a_refs.end());
+		});
+		std::ranges::sort(result);
+		return result;
+	}
+
+	void Manager::RestoreSwapDecisions(FormIDMap<SwapDecision>&& a_decisions, Set<RE::FormID>&& a_leveledItemRefs)
+	{
+		ClearSwapDecisions();
+		for (auto& [refID, decision] : a_decisions) {
+			swapDecisions.write(refID, [&](auto& a_shard) { a_shard.emplace(refID, std::move(decision)); });
+		}
+		for (const auto refID : a_leveledItemRefs) {
+			swappedLeveledItemRefs.write(refID, [&](auto& a_shard) { a_shard.insert(refID); });
+		}
+	}
+
+	void Manager::ClearSwapDecisions()
+	{
+		swapDecisions.clear();
+		swappedLeveledItemRefs.clear();
 	}
 
-	SwapFormResult Manager::GetSwapData(RE::TESObjectREFR* a_ref, const RE::TESForm* a_base, const RE::BGSMaterialSwap* a_materialSwap)
+	SwapFormResult Manager::GetSwapData(const RefContext& a_context, const RE::BGSMaterialSwap* a_materialSwap)
 	{
+		// restored from co-save, or swapped earlier this session
+		if (auto decision = GetSwapDecision(a_context)) {
+			return std::move(*decision);
+		}
+
+		NoExplain explain;
+
+		if (const auto shadow = ShadowEval::GetSingleton(); shadow->ShouldSample(a_context.GetRefID())) {
+			return shadow->Compare(
+				a_context,
+				[&] { return GetSwapData<ENGINE::kCompiled>(a_context, a_materialSwap, explain); },
+				[&] { return GetSwapData<ENGINE::kReference>(a_context, a_materialSwap, explain); },
+				[&] {
+					SwapExplain compiled;
+					{
+						[[maybe_unused]] const auto stage = compiled.BeginStage("compiled engine"sv);
+						GetSwapData<ENGINE::kCompiled>(a_context, a_materialSwap, compiled);
+					}
+					compiled.Print(false);
+
+					SwapExplain reference;
+					{
+						[[maybe_unused]] const auto stage = reference.BeginStage("reference engine"sv);
+						GetSwapData<ENGINE::kReference>(a_context, a_materialSwap, reference);
+					}
+					reference.Print(false);
+				});
+		}
+
+		return GetSwapData<ENGINE::kCompiled>(a_context, a_materialSwap, explain);
+	}
+
+	void Manager::ExplainSwapData(RE::TESObjectREFR* a_ref)
+	{
+		const auto base = a_ref ? a_ref->GetObjectReference() : nullptr;
+		if (!base) {
+			if (const auto console = RE::ConsoleLog::GetSingleton()) {
+				console->PrintLine("[BOS] explain : select a reference first");
+			}
+			return;
+		}
+
+		LoadFormsOnce();
+
+		SwapExplain explain;
+
+		// a swapped ref's base is the swap target, the rules are evaluated for the base it was swapped from
+		const auto                decision = FindSwapDecision(a_ref->GetFormID());
+		const RE::TESBoundObject* originalBase = base;
+		if (const auto form = decision ? RE::TESForm::GetFormByID<RE::TESBoundObject>(decision->baseID) : nullptr) {
+			originalBase = form;
+		}
+
+		const RE::BGSMaterialSwap* materialSwapForm{ nullptr };
+		if (const auto materialSwap = originalBase->As<RE::BGSModelMaterialSwap>()) {
+			materialSwapForm = materialSwap->swapForm;
+		}
+
 		SwapFormResult swapData{ nullptr, std::nullopt };
+		{
+			[[maybe_unused]] const auto stage = explain.BeginStage(std::format("[BOS] explain {:08X} ({} {:08X})", a_ref->GetFormID(), originalBase->GetFormEditorID(), originalBase->GetFormID()));
+			if (decision && decision->swapBase) {
+				explain.Log("swap decision {} {:08X} ignored, evaluating the rules again", decision->swapBase->GetFormEditorID(), decision->swapBase->GetFormID());
+			}
+			const RefContext context(a_ref, originalBase);
+			swapData = GetSwapData<ENGINE::kCompiled>(context, materialSwapForm, explain);
+		}
+
+		const auto& [swapBase, objectProperties] = swapData;
+		if (swapBase && swapBase != originalBase) {
+			explain.Log("result : swap to {} {:08X}", swapBase->GetFormEditorID(), swapBase->GetFormID());
+		} else {
+			explain.Log("result : no swap");
+		}
+		explain.Log("properties : {}", objectProperties && objectProperties->IsValid() ? "yes" : "none");
+
+		explain.Print();
+	}
+
+	template <ENGINE Engine, class Explain>
+	SwapFormResult Manager::GetSwapData(const RefContext& a_context, const RE::BGSMaterialSwap* a_materialSwap, Explain& a_explain)
+	{
+		const auto ref = a_context.GetRef();
+		const auto base = a_context.GetBase();
+
+		SwapFormResult swapData{ nullptr, std::nullopt };
+
+		// loaded rules, or lazily indexed ones compiled on first lookup
+		// the reference engine reads its eagerly parsed copy of the lazy keys instead
+		const auto find_rules = [a_materialSwap](const RE::TESForm* a_form, const auto& a_map, [[maybe_unused]] const auto& a_lazy, [[maybe_unused]] const auto& a_reference) {
+			const auto find = [&](RE::FormID a_formID) -> decltype(a_lazy.find(a_formID)) {
+				if (const auto it = a_map.find(a_formID); it != a_map.end()) {
+					return std::addressof(it->second);
+				}
+				if constexpr (Engine == ENGINE::kReference) {
+					const auto it = a_reference.find(a_formID);
+					return it != a_reference.end() ? std::addressof(it->second) : nullptr;
+				} else {
+					return a_lazy.find(a_formID);
+				}
+			};
+			const auto rules = find(a_form->GetFormID());
+			return !rules && a_materialSwap ? find(a_materialSwap->GetFormID()) : rules;
+		};
 
 		// get base
-		const auto get_swap_base = [a_ref, a_materialSwap](const RE::TESForm* a_form, const FormIDMap<SwapFormDataVec>& a_map) -> SwapFormResult {
-			auto it = a_map.find(a_form->GetFormID());
-			if (it == a_map.end() && a_materialSwap) {
-				it = a_map.find(a_materialSwap->GetFormID());
-			}
-			if (it != a_map.end()) {
-				for (auto& swapData : it->second | std::ranges::views::reverse) {
-					if (auto swapObject = swapData.GetSwapBase(a_ref)) {
+		const auto get_swap_base = [&](const RE::TESForm* a_form, const FormIDMap<SwapFormDataVec>& a_map, const LazyRuleMap<SwapFormData>& a_lazy, const FormIDMap<SwapFormDataVec>& a_reference) -> SwapFormResult {
+			if (const auto swapDataVec = find_rules(a_form, a_map, a_lazy, a_reference)) {
+				for (auto& swapData : *swapDataVec | std::ranges::views::reverse) {
+					if (auto swapObject = swapData.GetSwapBase(a_context, a_explain)) {
+						if constexpr (Explain::enabled) {
+							a_explain.Log("winner {} ({})", swapData.record, swapData.path);
+						}
 						return { swapObject, swapData.properties };
 					}
 				}
@@ -231,37 +1207,60 @@ namespace FormSwap
 			return { nullptr, std::nullopt };
 		};
 
-		if (!a_ref->IsCreated()) {
-			swapData = get_swap_base(a_ref, swapRefs);
+		if (!a_context.IsCreated()) {
+			[[maybe_unused]] const auto stage = a_explain.BeginStage("reference swaps"sv);
+			swapData = get_swap_base(ref, swapRefs, lazySwapRefs, referenceSwapRefs);
 		}
 
 		if (!swapData.first) {
-			swapData = GetSwapFormConditional(a_ref, a_base, a_materialSwap);
+			[[maybe_unused]] const auto stage = a_explain.BeginStage("conditional form swaps"sv);
+			swapData = GetSwapFormConditional<Engine>(a_context, a_materialSwap, a_explain);
 		}
 
 		if (!swapData.first) {
-			swapData = get_swap_base(a_base, swapForms);
+			[[maybe_unused]] const auto stage = a_explain.BeginStage("form swaps"sv);
+			swapData = get_swap_base(base, swapForms, lazySwapForms, referenceSwapForms);
+		}
+
+		if (!swapData.first && !wildcards.empty()) {
+			[[maybe_unused]] const auto stage = a_explain.BeginStage("wildcard swaps"sv);
+			swapData = wildcards.GetSwapBase(base, a_context, a_explain);
 		}
 
 		if (const auto swapLvlBase = swapData.first ? swapData.first->As<RE::TESLevItem>() : nullptr) {
-			if (a_ref->GetEncounterZone() == nullptr) {
-				RE::BSScrapArray<RE::CALCED_OBJECT> calcedObjects{};
-				swapLvlBase->CalculateCurrentFormListForRef(a_ref, calcedObjects, false);
-				if (calcedObjects.size() > 0) {
-					swapData.first = calcedObjects.front().object;
+			[[maybe_unused]] const auto stage = a_explain.BeginStage("leveled list"sv);
+			if (ref->GetEncounterZone() == nullptr) {
+				// the reference engine always asks the game, flattened lists are the compiled engine's
+				std::optional<RE::TESBoundObject*> picked;
+				if constexpr (Engine == ENGINE::kCompiled) {
+					picked = PickFlatLeveledList(swapLvlBase, a_context);
+				}
+				if (picked) {
+					if (*picked) {
+						swapData.first = *picked;
+					}
+				} else {
+					a_context.MarkNondeterministic();
+					RE::BSScrapArray<RE::CALCED_OBJECT> calcedObjects{};
+					swapLvlBase->CalculateCurrentFormListForRef(ref, calcedObjects, false);
+					if (calcedObjects.size() > 0) {
+						swapData.first = calcedObjects.front().object;
+					}
 				}
 			}
+			if constexpr (Explain::enabled) {
+				a_explain.Log("{} {:08X} -> {} {:08X}", swapLvlBase->GetFormEditorID(), swapLvlBase->GetFormID(), swapData.first->GetFormEditorID(), swapData.first->GetFormID());
+			}
 		}
 
 		// get object properties
 		const auto get_properties = [&](const RE::TESForm* a_form) -> std::optional<ObjectProperties> {
-			auto it = refProperties.find(a_form->GetFormID());
-			if (it == refProperties.end() && a_materialSwap) {
-				it = refProperties.find(a_materialSwap->GetFormID());
-			}
-			if (it != refProperties.end()) {
-				for (auto& objectData : it->second | std::ranges::views::reverse) {
-					if (objectData.HasValidProperties(a_ref)) {
+			if (const auto objectDataVec = find_rules(a_form, refProperties, lazyRefProperties, referenceRefProperties)) {
+				for (auto& objectData : *objectDataVec | std::ranges::views::reverse) {
+					if (objectData.HasValidProperties(a_context, a_explain)) {
+						if constexpr (Explain::enabled) {
+							a_explain.Log("winner {} ({})", objectData.record, objectData.path);
+						}
 						return objectData.properties;
 					}
 				}
@@ -273,16 +1272,19 @@ namespace FormSwap
 			return a_result && a_result->IsValid();
 		};
 
-		if (!has_properties(swapData.second) && !a_ref->IsCreated()) {
-			swapData.second = get_properties(a_ref);
+		if (!has_properties(swapData.second) && !a_context.IsCreated()) {
+			[[maybe_unused]] const auto stage = a_explain.BeginStage("reference properties"sv);
+			swapData.second = get_properties(ref);
 		}
 
 		if (!has_properties(swapData.second)) {
-			swapData.second = GetObjectPropertiesConditional(a_ref, a_base, a_materialSwap);
+			[[maybe_unused]] const auto stage = a_explain.BeginStage("conditional properties"sv);
+			swapData.second = GetObjectPropertiesConditional<Engine>(a_context, a_materialSwap, a_explain);
 		}
 
 		if (!has_properties(swapData.second)) {
-			swapData.second = get_properties(a_base);
+			[[maybe_unused]] const auto stage = a_explain.BeginStage("form properties"sv);
+			swapData.second = get_properties(base);
 		}
 
 		return swapData;
@@ -0,0 +1,133 @@
+#include "MemoryReport.h"
+
+MemoryReport::Usage& MemoryReport::Usage::operator+=(const Usage& a_rhs)
+{
+	entries += a_rhs.entries;
+	dataBytes += a_rhs.dataBytes;
+	stringBytes += a_rhs.stringBytes;
+	return *this;
+}
+
+std::size_t MemoryReport::string_bytes(const std::string& a_str)
+{
+	// small strings live inside the object
+	return a_str.capacity() > std::string{}.capacity() ? a_str.capacity() + 1 : 0;
+}
+
+MemoryReport::Table& MemoryReport::get_table(std::string_view a_name)
+{
+	if (const auto it = std::ranges::find(tables, a_name, &Table::name); it != tables.end()) {
+		return *it;
+	}
+	return tables.emplace_back(Table{ std::string(a_name) });
+}
+
+std::string MemoryReport::get_owner(std::string_view a_path, const Map<std::string, std::string>& a_plugins)
+{
+	auto stem = std::filesystem::path(a_path).stem().string();
+	if (string::tolower(stem).ends_with("_swap"sv)) {
+		stem.resize(stem.size() - 5);
+	}
+
+	// longest '_' separated prefix first
+	const auto lowerStem = string::tolower(stem);
+	for (auto name = std::string_view(lowerStem); !name.empty();) {
+		for (const auto extension : { ".esp"sv, ".esm"sv, ".esl"sv }) {
+			if (const auto it = a_plugins.find(std::string(name).append(extension)); it != a_plugins.end()) {
+				return it->second;
+			}
+		}
+		const auto pos = name.rfind('_');
+		name = pos != std::string_view::npos ? name.substr(0, pos) : std::string_view{};
+	}
+
+	return stem;
+}
+
+void MemoryReport::AddTable(std::string_view a_name, std::size_t a_keys, std::size_t a_tableBytes, float a_loadFactor)
+{
+	auto& table = get_table(a_name);
+	table.keys += a_keys;
+	table.tableBytes += a_tableBytes;
+	table.loadFactor = a_loadFactor;
+}
+
+void MemoryReport::AddRule(std::string_view a_name, const std::string& a_path, const Usage& a_usage)
+{
+	get_table(a_name).rules += a_usage;
+	paths[a_path] += a_usage;
+}
+
+void MemoryReport::AddShared(std::string_view a_name, const Usage& a_usage)
+{
+	shared.emplace_back(a_name, a_usage);
+}
+
+void MemoryReport::Log() const
+{
+	constexpr auto kb = [](std::size_t a_bytes) {
+		return static_cast<double>(a_bytes) / 1024.0;
+	};
+
+	logger::info("{:*^30}", "MEMORY");
+
+	std::size_t total = 0;
+	std::size_t totalStrings = 0;
+
+	for (const auto& [name, keys, tableBytes, loadFactor, rules] : tables) {
+		const auto bytes = tableBytes + rules.dataBytes + rules.stringBytes;
+		total += bytes;
+		totalStrings += rules.stringBytes;
+		logger::info("{} : {} keys, {} rules, {:.1f} KB (table {:.1f} KB at {:.2f} load, rules {:.1f} KB, strings {:.1f} KB)",
+			name, keys, rules.entries, kb(bytes), kb(tableBytes), loadFactor, kb(rules.dataBytes), kb(rules.stringBytes));
+	}
+	for (const auto& [name, usage] : shared) {
+		const auto bytes = usage.dataBytes + usage.stringBytes;
+		total += bytes;
+		totalStrings += usage.stringBytes;
+		logger::info("{} : {} entries, {:.1f} KB", name, usage.entries, kb(bytes));
+	}
+
+	logger::info("total : {:.1f} KB, {:.1f}% strings", kb(total), total > 0 ? 100.0 * static_cast<double>(totalStrings) / static_cast<double>(total) : 0.0);
+
+	if (paths.empty()) {
+		return;
+	}
+
+	constexpr auto bytes = [](const Usage& a_usage) {
+		return a_usage.dataBytes + a_usage.stringBytes;
+	};
+
+	Map<std::string, std::string> plugins;
+	if (const auto dataHandler = RE::TESDataHandler::GetSingleton()) {
+		for (const auto file : dataHandler->files) {
+			if (file) {
+				plugins.emplace(string::tolower(file->GetFilename()), file->GetFilename());
+			}
+		}
+	}
+
+	Map<std::string, std::pair<std::size_t, Usage>> owners;
+	for (const auto& [path, usage] : paths) {
+		auto& [files, ownerUsage] = owners[get_owner(path, plugins)];
+		files++;
+		ownerUsage += usage;
+	}
+
+	std::vector<std::pair<std::string_view, std::pair<std::size_t, Usage>>> sortedOwners(owners.begin(), owners.end());
+	std::ranges::sort(sortedOwners, std::greater{}, [&](const auto& a_pair) { return bytes(a_pair.second.second); });
+
+	logger::info("[by mod]");
+	for (const auto& [owner, value] : sortedOwners) {
+		const auto& [files, usage] = value;
+		logger::info("\t{} : {} files, {} rules, {:.1f} KB ({:.1f} KB strings)", owner, files, usage.entries, kb(bytes(usage)), kb(usage.stringBytes));
+	}
+
+	std::vector<std::pair<std::string_view, Usage>> sorted(paths.begin(), paths.end());
+	std::ranges::sort(sorted, std::greater{}, [&](const auto& a_pair) { return bytes(a_pair.second); });
+
+	logger::info("[by source]");
+	for (const auto& [path, usage] : sorted) {
+		logger::info("\t{} : {} rules, {:.1f} KB ({:.1f} KB strings)", path, usage.entries, kb(bytes(usage)), kb(usage.stringBytes));
+	}
+}
@@ -1,7 +1,9 @@
 #include "ObjectProperties.h"
+#include "RefContext.h"
+#include "Serialization.h"
 
-RandValueParams::RandValueParams(CHANCE_TYPE a_type, const RE::TESObjectREFR* a_ref) :
-	rng(a_type, a_ref)
+RandValueParams::RandValueParams(CHANCE_TYPE a_type, const RefContext& a_context) :
+	rng(a_type, a_context)
 {}
 
 FloatRange::FloatRange(const std::string& a_str)
@@ -13,7 +15,7 @@ FloatRange::FloatRange(const std::string& a_str)
 
 bool FloatRange::operator==(const FloatRange& a_rhs) const
 {
-	return (min == a_rhs.min && max == a_rhs.min);
+	return (min == a_rhs.min && max == a_rhs.max);
 }
 
 bool FloatRange::operator!=(const FloatRange& a_rhs) const
@@ -134,6 +136,14 @@ ObjectProperties::ObjectProperties(const std::string& a_str)
 	}
 }
 
+ObjectProperties::ObjectProperties(std::optional<Point3Range> a_location, std::optional<Point3Range> a_rotation, std::optional<ScaleRange> a_refScale, std::uint32_t a_flagsSet, std::uint32_t a_flagsUnset) :
+	location(std::move(a_location)),
+	rotation(std::move(a_rotation)),
+	refScale(std::move(a_refScale)),
+	recordFlagsSet(a_flagsSet),
+	recordFlagsUnset(a_flagsUnset)
+{}
+
 bool ObjectProperties::IsValid() const
 {
 	return location || rotation || refScale || recordFlagsSet != 0 || recordFlagsUnset != 0;
@@ -144,24 +154,26 @@ void ObjectProperties::SetChanceType(CHANCE_TYPE a_type)
 	chanceType = a_type;
 }
 
-void ObjectProperties::SetTransform(RE::TESObjectREFR* a_refr) const
+void ObjectProperties::SetTransform(const RefContext& a_context) const
 {
 	if (location || rotation || refScale) {
-		RandValueParams params(chanceType, a_refr);
+		const auto refr = a_context.GetRef();
+
+		RandValueParams params(chanceType, a_context);
 		if (location) {
-			location->SetTransform(a_refr->data.location, params);
+			location->SetTransform(refr->data.location, params);
 		}
 		if (rotation) {
 			params.clamp = true;
 			params.clampMin = -RE::TWO_PI;
 			params.clampMax = RE::TWO_PI;
-			rotation->SetTransform(a_refr->data.angle, params);
+			rotation->SetTransform(refr->data.angle, params);
 		}
 		if (refScale) {
 			params.clamp = true;
 			params.clampMin = 0.0f;
 			params.clampMax = 1000.0f;
-			refScale->SetScale(a_refr, params);
+			refScale->SetScale(refr, params);
 		}
 	}
 }
@@ -176,3 +188,84 @@ void ObjectProperties::SetRecordFlags(RE::TESObjectREFR* a_refr) const
 		a_refr->formFlags |= recordFlagsSet;
 	}
 }
+
+void ObjectProperties::Save(std::vector<std::uint8_t>& a_buf) const
+{
+	using namespace Serialization;
+
+	const auto write_range = [&](const FloatRange& a_range) {
+		WriteFixed(a_buf, a_range.min);
+		WriteFixed(a_buf, a_range.max);
+	};
+	const auto write_point3 = [&](const std::optional<Point3Range>& a_point) {
+		WriteFixed(a_buf, static_cast<std::uint8_t>(a_point.has_value()));
+		if (a_point) {
+			WriteFixed(a_buf, static_cast<std::uint8_t>(a_point->relative));
+			write_range(a_point->x);
+			write_range(a_point->y);
+			write_range(a_point->z);
+		}
+	};
+
+	WriteFixed(a_buf, static_cast<std::uint8_t>(chanceType));
+	write_point3(location);
+	write_point3(rotation);
+	WriteFixed(a_buf, static_cast<std::uint8_t>(refScale.has_value()));
+	if (refScale) {
+		WriteFixed(a_buf, static_cast<std::uint8_t>(refScale->absolute));
+		write_range(refScale->value);
+	}
+	WriteVarint(a_buf, recordFlagsSet);
+	WriteVarint(a_buf, recordFlagsUnset);
+}
+
+bool ObjectProperties::Load(std::span<const std::uint8_t> a_buf, std::size_t& a_pos)
+{
+	using namespace Serialization;
+
+	const auto read_bool = [&](bool& a_value) {
+		std::uint8_t value = 0;
+		if (!ReadFixed(a_buf, a_pos, value)) {
+			return false;
+		}
+		a_value = value != 0;
+		return true;
+	};
+	const auto read_range = [&](FloatRange& a_range) {
+		return ReadFixed(a_buf, a_pos, a_range.min) && ReadFixed(a_buf, a_pos, a_range.max);
+	};
+	const auto read_point3 = [&](std::optional<Point3Range>& a_point) {
+		bool present = false;
+		if (!read_bool(present)) {
+			return false;
+		}
+		if (present) {
+			a_point.emplace();
+			return read_bool(a_point->relative) && read_range(a_point->x) && read_range(a_point->y) && read_range(a_point->z);
+		}
+		return true;
+	};
+
+	std::uint8_t type = 0;
+	if (!ReadFixed(a_buf, a_pos, type) || type > std::to_underlying(CHANCE_TYPE::kLocationHash)) {
+		return false;
+	}
+	chanceType = static_cast<CHANCE_TYPE>(type);
+
+	if (!read_point3(location) || !read_point3(rotation)) {
+		return false;
+	}
+
+	bool hasScale = false;
+	if (!read_bool(hasScale)) {
+		return false;
+	}
+	if (hasScale) {
+		refScale.emplace();
+		if (!read_bool(refScale->absolute) || !read_range(refScale->value)) {
+			return false;
+		}
+	}
+
+	return ReadVarint(a_buf, a_pos, recordFlagsSet) && ReadVarint(a_buf, a_pos, recordFlagsUnset);
+}
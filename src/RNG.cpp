@@ -1,33 +1,26 @@
 #include "RNG.h"
+#include "RefContext.h"
 
-BOS_RNG::BOS_RNG(CHANCE_TYPE a_type, const RE::TESObjectREFR* a_ref) :
+BOS_RNG::BOS_RNG(CHANCE_TYPE a_type, const RefContext& a_context) :
 	type(a_type)
 {
 	switch (type) {
 	case CHANCE_TYPE::kRefHash:
-		seed = a_ref->GetFormID();
+		seed = a_context.GetRefID();
 		break;
 	case CHANCE_TYPE::kLocationHash:
 		{
-			auto baseID = a_ref->GetObjectReference()->GetFormID();
-			auto location = a_ref->GetCurrentLocation();
-			auto cell = a_ref->GetSaveParentCell();
-
-			if (!location && !cell) {
-				seed = a_ref->GetFormID();
+			if (const auto locID = a_context.GetLocationSeedID(); locID == 0) {
+				seed = a_context.GetRefID();
 			} else {
-				RE::FormID locID = 0;
-				if (location) {
-					locID = location->GetFormID();
-				} else if (cell) {
-					locID = cell->GetFormID();
-				}
-				// generate hash based on location + baseID
+				// generate hash based on location + current baseID
+				const auto baseID = a_context.GetRef()->GetObjectReference()->GetFormID();
 				seed = hash::szudzik_pair(locID, baseID);
 			}
 		}
 		break;
 	default:
+		a_context.MarkNondeterministic();
 		break;
 	}
 }
@@ -50,13 +43,13 @@ Chance::Chance(const std::string& a_str)
 	}
 }
 
-bool Chance::PassedChance(const RE::TESObjectREFR* a_ref) const
+Chance::Chance(CHANCE_TYPE a_type, float a_value) :
+	chanceType(a_type),
+	chanceValue(std::clamp(a_value, 0.0f, 100.0f))
+{}
+
+bool Chance::PassedChance(const RefContext& a_context) const
 {
-	if (chanceValue < 100.0f) {
-		BOS_RNG rng(chanceType, a_ref);
-		if (const auto rngValue = rng.generate<float>(0.0f, 100.0f); rngValue > chanceValue) {
-			return false;
-		}
-	}
-	return true;
+	NoExplain explain;
+	return PassedChance(a_context, explain);
 }
@@ -0,0 +1,93 @@
+#include "RefContext.h"
+#include "SpatialIndex.h"
+
+RefContext::RefContext(RE::TESObjectREFR* a_ref, const RE::TESForm* a_base) :
+	ref(a_ref),
+	base(a_base),
+	refID(a_ref->GetFormID())
+{}
+
+RefContext::~RefContext()
+{
+	totalRefs.fetch_add(1, std::memory_order_relaxed);
+	totalRequested.fetch_add(requested, std::memory_order_relaxed);
+	totalPerformed.fetch_add(performed, std::memory_order_relaxed);
+}
+
+bool RefContext::IsCreated() const
+{
+	return get(isCreated, [this] { return ref->IsCreated(); });
+}
+
+RE::TESObjectCELL* RefContext::GetCell() const
+{
+	return get(cell, [this] { return ref->GetSaveParentCell(); });
+}
+
+RE::BGSLocation* RefContext::GetLocation() const
+{
+	return get(location, [this] { return ref->GetCurrentLocation(); });
+}
+
+const CellData& RefContext::GetCellData() const
+{
+	static const CellData noCell{};
+
+	requested++;
+	if (!cellData) {
+		const auto currentCell = GetCell();
+		if (!currentCell) {
+			return noCell;
+		}
+		const auto cache = CellDataCache::GetSingleton();
+		cellData = cache->Find(currentCell);
+		if (!cellData) {
+			performed++;
+			const auto start = std::chrono::steady_clock::now();
+			CellData   data(currentCell);
+			cache->RecordMiss(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+			// built on the thread attaching the cell, shared with its other refs
+			cellData = cache->Insert(currentCell, std::move(data));
+		}
+	}
+	return *cellData;
+}
+
+const std::vector<std::uint32_t>& RefContext::GetSpatialMatches() const
+{
+	return get(spatialMatches, [this] {
+		std::vector<std::uint32_t> matches;
+		if (const auto currentCell = GetCell(); currentCell && currentCell->IsExterior()) {
+			SpatialIndex::GetSingleton()->GetMatches(currentCell->worldSpace, ref->data.location, matches);
+		}
+		return matches;
+	});
+}
+
+RE::FormID RefContext::GetLocationSeedID() const
+{
+	if (const auto currentLocation = GetLocation()) {
+		return currentLocation->GetFormID();
+	}
+	if (const auto currentCell = GetCell()) {
+		return currentCell->GetFormID();
+	}
+	return 0;
+}
+
+void RefContext::LogStats()
+{
+	const auto refs = totalRefs.exchange(0);
+	const auto requestedCalls = totalRequested.exchange(0);
+	const auto performedCalls = totalPerformed.exchange(0);
+
+	if (refs == 0) {
+		return;
+	}
+
+	logger::info("{} refs evaluated : {} engine queries requested, {} performed ({:.2f} saved per ref)",
+		refs,
+		requestedCalls,
+		performedCalls,
+		static_cast<double>(requestedCalls - performedCalls) / static_cast<double>(refs));
+}
@@ -0,0 +1,169 @@
+#include "Serialization.h"
+#include "Manager.h"
+
+namespace Serialization
+{
+	void WriteVarint(std::vector<std::uint8_t>& a_buf, std::uint32_t a_value)
+	{
+		while (a_value >= 0x80) {
+			a_buf.push_back(static_cast<std::uint8_t>(a_value | 0x80));
+			a_value >>= 7;
+		}
+		a_buf.push_back(static_cast<std::uint8_t>(a_value));
+	}
+
+	bool ReadVarint(std::span<const std::uint8_t> a_buf, std::size_t& a_pos, std::uint32_t& a_value)
+	{
+		a_value = 0;
+		for (std::uint32_t shift = 0; shift < 35 && a_pos < a_buf.size(); shift += 7) {
+			const auto byte = a_buf[a_pos++];
+			a_value |= static_cast<std::uint32_t>(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void SaveCallback(const F4SE::SerializationInterface* a_intfc)
+	{
+		const auto manager = FormSwap::Manager::GetSingleton();
+
+		std::vector<std::uint8_t> buf;
+
+		// count and rule set fingerprint, then per decision :
+		// refID delta, original base, swap base, properties flag and properties
+		const auto decisions = manager->GetSwapDecisions();
+		buf.reserve(decisions.size() * 12 + 13);
+		WriteVarint(buf, static_cast<std::uint32_t>(decisions.size()));
+		WriteFixed(buf, manager->GetRulesFingerprint());
+		RE::FormID prevRefID = 0;
+		for (const auto& [refID, decision] : decisions) {
+			WriteVarint(buf, refID - prevRefID);
+			WriteVarint(buf, decision.baseID);
+			WriteVarint(buf, decision.swapBase->GetFormID());
+			WriteFixed(buf, static_cast<std::uint8_t>(decision.properties.has_value()));
+			if (decision.properties) {
+				decision.properties->Save(buf);
+			}
+			prevRefID = refID;
+		}
+		if (!a_intfc->WriteRecord(kSwapDecisions, kSerializationVersion, buf.data(), static_cast<std::uint32_t>(buf.size()))) {
+			logger::error("Failed to save swap decisions");
+		}
+
+		buf.clear();
+
+		const auto leveledRefs = manager->GetLeveledItemRefs();
+		WriteVarint(buf, static_cast<std::uint32_t>(leveledRefs.size()));
+		prevRefID = 0;
+		for (const auto refID : leveledRefs) {
+			WriteVarint(buf, refID - prevRefID);
+			prevRefID = refID;
+		}
+		if (!a_intfc->WriteRecord(kLeveledItemRefs, kSerializationVersion, buf.data(), static_cast<std::uint32_t>(buf.size()))) {
+			logger::error("Failed to save swapped leveled item refs");
+		}
+	}
+
+	void LoadCallback(const F4SE::SerializationInterface* a_intfc)
+	{
+		// rules have to be loaded before saved decisions can be checked against their fingerprint
+		const auto manager = FormSwap::Manager::GetSingleton();
+		manager->LoadFormsOnce();
+
+		FormIDMap<FormSwap::SwapDecision> decisions;
+		Set<RE::FormID>                   leveledRefs;
+
+		std::uint32_t type;
+		std::uint32_t version;
+		std::uint32_t length;
+		while (a_intfc->GetNextRecordInfo(type, version, length)) {
+			if (version != kSerializationVersion) {
+				logger::warn("Skipping co-save record with version {} (expected {})", version, kSerializationVersion);
+				continue;
+			}
+
+			std::vector<std::uint8_t> buf(length);
+			if (a_intfc->ReadRecordData(buf.data(), length) != length) {
+				logger::error("Failed to read co-save record");
+				continue;
+			}
+
+			std::size_t   pos = 0;
+			std::uint32_t count = 0;
+			if (!ReadVarint(buf, pos, count)) {
+				continue;
+			}
+
+			switch (type) {
+			case kSwapDecisions:
+				{
+					std::uint64_t fingerprint = 0;
+					if (!ReadFixed(buf, pos, fingerprint)) {
+						logger::error("Truncated swap decision record");
+						break;
+					}
+					if (fingerprint != manager->GetRulesFingerprint()) {
+						logger::info("_SWAP.ini files or API rules changed since this save, {} swap decisions dropped", count);
+						break;
+					}
+
+					decisions.reserve(count);
+					RE::FormID refID = 0;
+					for (std::uint32_t i = 0; i < count; ++i) {
+						std::uint32_t                   delta;
+						std::uint32_t                   baseID;
+						std::uint32_t                   swapBaseID;
+						std::uint8_t                    hasProperties = 0;
+						std::optional<ObjectProperties> properties{};
+						if (!ReadVarint(buf, pos, delta) || !ReadVarint(buf, pos, baseID) || !ReadVarint(buf, pos, swapBaseID) || !ReadFixed(buf, pos, hasProperties) ||
+							(hasProperties && !properties.emplace().Load(buf, pos))) {
+							logger::error("Truncated swap decision record ({}/{} read)", i, count);
+							break;
+						}
+						refID += delta;
+						const auto newRefID = a_intfc->ResolveFormID(refID);
+						const auto newBaseID = a_intfc->ResolveFormID(baseID);
+						const auto newSwapBaseID = a_intfc->ResolveFormID(swapBaseID);
+						if (newRefID && newBaseID && newSwapBaseID) {
+							if (const auto swapBase = RE::TESForm::GetFormByID<RE::TESBoundObject>(*newSwapBaseID)) {
+								decisions.emplace(*newRefID, FormSwap::SwapDecision{ *newBaseID, swapBase, std::move(properties) });
+							}
+						}
+					}
+				}
+				break;
+			case kLeveledItemRefs:
+				{
+					leveledRefs.reserve(count);
+					RE::FormID refID = 0;
+					for (std::uint32_t i = 0; i < count; ++i) {
+						std::uint32_t delta;
+						if (!ReadVarint(buf, pos, delta)) {
+							logger::error("Truncated leveled item ref record ({}/{} read)", i, count);
+							break;
+						}
+						refID += delta;
+						if (const auto newRefID = a_intfc->ResolveFormID(refID)) {
+							leveledRefs.emplace(*newRefID);
+						}
+					}
+				}
+				break;
+			default:
+				logger::warn("Unknown co-save record type {:X}", type);
+				break;
+			}
+		}
+
+		logger::info("Restored {} swap decisions, {} swapped leveled item refs", decisions.size(), leveledRefs.size());
+
+		manager->RestoreSwapDecisions(std::move(decisions), std::move(leveledRefs));
+	}
+
+	void RevertCallback(const F4SE::SerializationInterface*)
+	{
+		FormSwap::Manager::GetSingleton()->ClearSwapDecisions();
+	}
+}
@@ -0,0 +1,21 @@
+#include "Settings.h"
+
+void Settings::Load()
+{
+	const auto path = std::format("Data\\F4SE\\Plugins\\{}.ini", Version::PROJECT);
+
+	CSimpleIniA settings;
+	settings.SetUnicode();
+
+	if (settings.LoadFile(path.c_str()) < 0) {
+		return;
+	}
+
+	lazyRules = settings.GetBoolValue("Load", "bLazyRules", false);
+	recordTrace = settings.GetBoolValue("Debug", "bRecordTrace", false);
+	profileFilters = settings.GetBoolValue("Debug", "bProfileFilters", false);
+	profileLoad = settings.GetBoolValue("Debug", "bProfileLoad", false);
+	shadowSampleRate = static_cast<float>(settings.GetDoubleValue("Debug", "fShadowSampleRate", 0.0));
+
+	logger::info("Settings : lazy rules {}, record trace {}, profile filters {}, profile load {}, shadow sample rate {}", lazyRules, recordTrace, profileFilters, profileLoad, shadowSampleRate);
+}
@@ -0,0 +1,71 @@
+#include "ShadowEval.h"
+#include "Settings.h"
+
+namespace detail
+{
+	std::string describe(const FormSwap::SwapFormResult& a_result)
+	{
+		const auto& [base, properties] = a_result;
+
+		auto result = base ? std::format("{} {:08X}", base->GetFormEditorID(), base->GetFormID()) : "no swap"s;
+		if (properties) {
+			result += " with properties";
+		}
+		return result;
+	}
+}
+
+void ShadowEval::Start()
+{
+	const auto rate = std::clamp(Settings::GetSingleton()->shadowSampleRate, 0.0f, 1.0f);
+	threshold = static_cast<std::uint64_t>(static_cast<double>(rate) * 4294967296.0);
+
+	if (threshold != 0) {
+		logger::info("Shadow evaluation on {:.1f}% of refs", rate * 100.0f);
+	}
+}
+
+void ShadowEval::log_divergence(const RefContext& a_context, const FormSwap::SwapFormResult& a_compiled, const FormSwap::SwapFormResult& a_reference)
+{
+	const auto base = a_context.GetBase();
+	const auto cell = a_context.GetCell();
+
+	logger::warn("[SHADOW] {:08X} ({} {:08X}) in {} {:08X} : compiled {}, reference {}",
+		a_context.GetRefID(),
+		base->GetFormEditorID(),
+		base->GetFormID(),
+		cell ? cell->GetFormEditorID() : "",
+		cell ? cell->GetFormID() : 0,
+		detail::describe(a_compiled),
+		detail::describe(a_reference));
+}
+
+void ShadowEval::LogStats()
+{
+	const auto sampleCount = samples.exchange(0);
+	const auto matchCount = matches.exchange(0);
+	const auto divergenceCount = divergences.exchange(0);
+	const auto nondeterministicCount = nondeterministic.exchange(0);
+	const auto compiledNs = compiledTime.exchange(0);
+	const auto referenceNs = referenceTime.exchange(0);
+
+	if (sampleCount == 0) {
+		return;
+	}
+
+	const auto avgCompiled = static_cast<double>(compiledNs) / static_cast<double>(sampleCount);
+	const auto avgReference = static_cast<double>(referenceNs) / static_cast<double>(sampleCount);
+
+	logger::info("shadow : {} samples, {} matched, {} diverged, {} skipped (random), compiled ~{:.0f} ns, reference ~{:.0f} ns ({:.2f}x)",
+		sampleCount,
+		matchCount,
+		divergenceCount,
+		nondeterministicCount,
+		avgCompiled,
+		avgReference,
+		avgCompiled > 0.0 ? avgReference / avgCompiled : 0.0);
+
+	if (divergenceCount > 0) {
+		logger::error("shadow : compiled engine diverged from the reference engine on {} refs, check [SHADOW] lines", divergenceCount);
+	}
+}
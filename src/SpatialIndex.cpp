@@ -0,0 +1,182 @@
+#include "SpatialIndex.h"
+#include "LoadErrors.h"
+
+bool SpatialIndex::IsSpatialFilter(const std::string& a_str)
+{
+	return a_str.starts_with("radius(") || a_str.starts_with("box(") || a_str.starts_with("cells(");
+}
+
+std::optional<SpatialID> SpatialIndex::Parse(const std::string& a_str)
+{
+	if (const auto it = regionIDs.find(a_str); it != regionIDs.end()) {
+		return SpatialID{ it->second };
+	}
+
+	srell::cmatch match;
+	if (!srell::regex_search(a_str.c_str(), match, regex::generic)) {
+		LoadErrors::GetSingleton()->Report(LoadErrors::TYPE::kSpatialMalformed, a_str);
+		return std::nullopt;
+	}
+
+	auto args = string::split(match[1].str(), ",");
+	for (auto& arg : args) {
+		arg.erase(0, arg.find_first_not_of(' '));
+		arg.erase(arg.find_last_not_of(' ') + 1);
+	}
+
+	const auto worldspace = RE::TESForm::GetFormByID<RE::TESWorldSpace>(util::GetFormID(args[0]));
+	if (!worldspace) {
+		LoadErrors::GetSingleton()->Report(LoadErrors::TYPE::kSpatialWorldspaceNotFound, a_str);
+		return std::nullopt;
+	}
+
+	std::vector<float> values;
+	values.reserve(args.size() - 1);
+	for (auto it = args.begin() + 1; it != args.end(); ++it) {
+		float value = 0.0f;
+		if (const auto [ptr, ec] = std::from_chars(it->data(), it->data() + it->size(), value); ec != std::errc{} || ptr != it->data() + it->size()) {
+			LoadErrors::GetSingleton()->Report(LoadErrors::TYPE::kSpatialArguments, a_str);
+			return std::nullopt;
+		}
+		values.push_back(value);
+	}
+
+	Region region;
+	region.worldspace = worldspace->GetFormID();
+
+	if (a_str.starts_with("radius(") && (values.size() == 3 || values.size() == 4)) {
+		const auto radius = values.back();
+		region.type = values.size() == 3 ? Region::TYPE::kRadius2D : Region::TYPE::kRadius3D;
+		region.center = RE::NiPoint3(values[0], values[1], values.size() == 4 ? values[2] : 0.0f);
+		region.radiusSquared = radius * radius;
+		region.min = region.center - RE::NiPoint3(radius, radius, radius);
+		region.max = region.center + RE::NiPoint3(radius, radius, radius);
+	} else if (a_str.starts_with("box(") && values.size() == 6) {
+		region.min = RE::NiPoint3(std::min(values[0], values[3]), std::min(values[1], values[4]), std::min(values[2], values[5]));
+		region.max = RE::NiPoint3(std::max(values[0], values[3]), std::max(values[1], values[4]), std::max(values[2], values[5]));
+	} else if (a_str.starts_with("cells(") && values.size() == 4) {
+		constexpr auto lowest = std::numeric_limits<float>::lowest();
+		constexpr auto highest = std::numeric_limits<float>::max();
+		region.min = RE::NiPoint3(std::min(values[0], values[2]) * bucketSize, std::min(values[1], values[3]) * bucketSize, lowest);
+		region.max = RE::NiPoint3((std::max(values[0], values[2]) + 1) * bucketSize, (std::max(values[1], values[3]) + 1) * bucketSize, highest);
+	} else {
+		LoadErrors::GetSingleton()->Report(LoadErrors::TYPE::kSpatialArguments, a_str);
+		return std::nullopt;
+	}
+
+	const auto id = static_cast<std::uint32_t>(regions.size());
+	regions.push_back(region);
+	regionIDs.emplace(a_str, id);
+
+	return SpatialID{ id };
+}
+
+void SpatialIndex::Build()
+{
+	grids.clear();
+
+	for (std::uint32_t id = 0; id < regions.size(); ++id) {
+		const auto& region = regions[id];
+		auto&       grid = grids[region.worldspace];
+
+		const auto minX = to_bucket(region.min.x);
+		const auto minY = to_bucket(region.min.y);
+		const auto maxX = to_bucket(region.max.x);
+		const auto maxY = to_bucket(region.max.y);
+
+		const auto numBuckets = static_cast<std::uint64_t>(maxX - minX + 1) * static_cast<std::uint64_t>(maxY - minY + 1);
+		if (numBuckets > maxBucketsPerRegion) {
+			grid.largeRegions.push_back(id);
+			continue;
+		}
+
+		for (auto x = minX; x <= maxX; ++x) {
+			for (auto y = minY; y <= maxY; ++y) {
+				grid.buckets[bucket_key(x, y)].push_back(id);
+			}
+		}
+	}
+
+	if (!regions.empty()) {
+		logger::info("{} spatial filters in {} worldspaces", regions.size(), grids.size());
+	}
+}
+
+void SpatialIndex::GetMatches(const RE::TESWorldSpace* a_worldspace, const RE::NiPoint3& a_pos, std::vector<std::uint32_t>& a_matches) const
+{
+	a_matches.clear();
+
+	if (!a_worldspace) {
+		return;
+	}
+
+	const auto gridIt = grids.find(a_worldspace->GetFormID());
+	if (gridIt == grids.end()) {
+		return;
+	}
+
+	const auto& grid = gridIt->second;
+	if (const auto it = grid.buckets.find(bucket_key(to_bucket(a_pos.x), to_bucket(a_pos.y))); it != grid.buckets.end()) {
+		for (const auto id : it->second) {
+			if (regions[id].Contains(a_pos)) {
+				a_matches.push_back(id);
+			}
+		}
+	}
+	for (const auto id : grid.largeRegions) {
+		if (regions[id].Contains(a_pos)) {
+			a_matches.push_back(id);
+		}
+	}
+
+	std::ranges::sort(a_matches);
+}
+
+bool SpatialIndex::empty() const
+{
+	return regions.empty();
+}
+
+std::string SpatialIndex::GetSource(SpatialID a_spatialID) const
+{
+	const auto it = std::ranges::find(regionIDs, a_spatialID.value, [](const auto& a_pair) { return a_pair.second; });
+	return it != regionIDs.end() ? it->first : std::string{};
+}
+
+RE::FormID SpatialIndex::GetWorldspace(SpatialID a_spatialID) const
+{
+	return a_spatialID.value < regions.size() ? regions[a_spatialID.value].worldspace : 0;
+}
+
+bool SpatialIndex::Region::Contains(const RE::NiPoint3& a_pos) const
+{
+	switch (type) {
+	case TYPE::kRadius2D:
+		{
+			const auto dx = a_pos.x - center.x;
+			const auto dy = a_pos.y - center.y;
+			return dx * dx + dy * dy <= radiusSquared;
+		}
+	case TYPE::kRadius3D:
+		{
+			const auto dx = a_pos.x - center.x;
+			const auto dy = a_pos.y - center.y;
+			const auto dz = a_pos.z - center.z;
+			return dx * dx + dy * dy + dz * dz <= radiusSquared;
+		}
+	default:
+		return a_pos.x >= min.x && a_pos.x <= max.x &&
+		       a_pos.y >= min.y && a_pos.y <= max.y &&
+		       a_pos.z >= min.z && a_pos.z <= max.z;
+	}
+}
+
+std::int32_t SpatialIndex::to_bucket(float a_coord)
+{
+	return static_cast<std::int32_t>(std::floor(a_coord / bucketSize));
+}
+
+std::uint64_t SpatialIndex::bucket_key(std::int32_t a_x, std::int32_t a_y)
+{
+	return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(a_x)) << 32) | static_cast<std::uint32_t>(a_y);
+}
@@ -1,4 +1,6 @@
 #include "SwapData.h"
+#include "LoadErrors.h"
+#include "LoadProfiler.h"
 
 namespace FormSwap
 {
@@ -11,24 +13,33 @@ namespace FormSwap
 		properties.SetChanceType(chance.chanceType);
 	}
 
-	bool ObjectData::HasValidProperties(const RE::TESObjectREFR* a_ref) const
+	ObjectData::ObjectData(const ObjectProperties& a_properties, const Chance& a_chance, std::string a_record, std::string a_path) :
+		properties(a_properties),
+		chance(a_chance),
+		record(std::move(a_record)),
+		path(std::move(a_path))
 	{
-		return chance.PassedChance(a_ref) && properties.IsValid();
+		properties.SetChanceType(chance.chanceType);
+	}
+
+	bool ObjectData::HasValidProperties(const RefContext& a_context) const
+	{
+		NoExplain explain;
+		return HasValidProperties(a_context, explain);
 	}
 
 	void ObjectData::GetProperties(const std::string& a_path, const std::string& a_str, std::function<void(RE::FormID, ObjectData&)> a_func)
 	{
-		const auto formPair = string::split(a_str, "|");
-		if (const auto baseFormID = util::GetFormID(formPair[0]); baseFormID != 0) {
+		LoadProfiler::ScopedTimer timer(LoadProfiler::STAGE::kGetProperties, a_str.size());
+
+		if (const auto line = core::ParsePropertiesLine(util::GameFormLookup{}, a_str)) {
 			const Input input(
-				formPair[1],                                        // properties
-				formPair.size() > 2 ? formPair[2] : std::string{},  // chance
+				std::string(line->properties),
+				std::string(line->chance),
 				a_str,
 				a_path);
 			ObjectData objectData(input);
-			a_func(baseFormID, objectData);
-		} else {
-			logger::error("\t\t\t\tfail : [{}] (BASE formID not found)", a_str);
+			a_func(line->baseID, objectData);
 		}
 	}
 
@@ -37,63 +48,58 @@ namespace FormSwap
 		formIDSet(std::move(a_id))
 	{}
 
-	RE::TESBoundObject* SwapFormData::GetSwapBase(const RE::TESObjectREFR* a_ref) const
-	{
-		if (!chance.PassedChance(a_ref)) {
-			return nullptr;
-		}
-
-		if (const auto formID = std::get_if<RE::FormID>(&formIDSet); formID) {
-			return RE::TESForm::GetFormByID<RE::TESBoundObject>(*formID);
-		} else {  // return random element from set
-			auto& set = std::get<FormIDSet>(formIDSet);
-
-			const auto setEnd = std::distance(set.begin(), set.end()) - 1;
-			const auto randIt = BOS_RNG(chance.chanceType, a_ref).generate<std::int64_t>(0, setEnd);
+	SwapFormData::SwapFormData(FormIDOrSet a_id, const ObjectData& a_objectData) :
+		ObjectData(a_objectData),
+		formIDSet(std::move(a_id))
+	{}
 
-			return RE::TESForm::GetFormByID<RE::TESBoundObject>(*std::next(set.begin(), randIt));
-		}
+	RE::TESBoundObject* SwapFormData::GetSwapBase(const RefContext& a_context) const
+	{
+		NoExplain explain;
+		return GetSwapBase(a_context, explain);
 	}
 
-	void SwapFormData::GetForms(const std::string& a_path, const std::string& a_str, std::function<void(RE::FormID, SwapFormData&)> a_func)
+	bool SwapFormData::ResolveSwapObjects()
 	{
-		constexpr auto swap_empty = [](const FormIDOrSet& a_set) {
-			if (const auto formID = std::get_if<RE::FormID>(&a_set); formID) {
-				return *formID == 0;
+		const auto resolve = [&](RE::FormID a_formID) {
+			const auto form = RE::TESForm::GetFormByID(a_formID);
+			if (!form) {
+				LoadErrors::GetSingleton()->Report(LoadErrors::TYPE::kSwapNotFound, record);
+			} else if (form->IsDeleted()) {
+				LoadErrors::GetSingleton()->Report(LoadErrors::TYPE::kSwapDeleted, record);
+			} else if (const auto object = form->As<RE::TESBoundObject>(); !object) {
+				LoadErrors::GetSingleton()->Report(LoadErrors::TYPE::kSwapNotBoundObject, record);
 			} else {
-				return std::get<FormIDSet>(a_set).empty();
+				swapObjects.push_back(object);
 			}
 		};
 
-		constexpr auto base_same_as_swap = [](RE::FormID a_baseID, const FormIDOrSet& a_set) {
-			if (const auto formID = std::get_if<RE::FormID>(&a_set); formID) {
-				return *formID == a_baseID;
-			} else {
-				return false;
-			}
-		};
+		swapObjects.clear();
+		std::visit(overload{
+					   [&](RE::FormID a_formID) { resolve(a_formID); },
+					   [&](const FormIDSet& a_set) {
+						   swapObjects.reserve(a_set.size());
+						   std::ranges::for_each(a_set, resolve);
+					   } },
+			formIDSet);
+		swapObjects.shrink_to_fit();
 
-		const auto formPair = string::split(a_str, "|");
-
-		if (const auto baseFormID = util::GetFormID(formPair[0]); baseFormID != 0) {
-			if (const auto swapFormID = util::GetSwapFormID(formPair[1]); !swap_empty(swapFormID)) {
-				auto properties = formPair.size() > 2 ? formPair[2] : std::string{};
-				auto chance = formPair.size() > 3 ? formPair[3] : std::string{};
+		return !swapObjects.empty();
+	}
 
-				if (base_same_as_swap(baseFormID, swapFormID) && !distribution::is_valid_entry(properties)) {
-					logger::error("\t\t\t\tfail : [{}] (BASE formID == SWAP formID)", a_str);
-					return;
-				}
+	void SwapFormData::GetForms(const std::string& a_path, const std::string& a_str, std::function<void(RE::FormID, SwapFormData&)> a_func)
+	{
+		LoadProfiler::ScopedTimer timer(LoadProfiler::STAGE::kGetForms, a_str.size());
 
-				const Input input(properties, chance, a_str, a_path);
-				SwapFormData swapFormData(swapFormID, input);
+		if (const auto line = core::ParseSwapLine(util::GameFormLookup{}, a_str)) {
+			const Input input(
+				std::string(line->properties),
+				std::string(line->chance),
+				a_str,
+				a_path);
+			SwapFormData swapFormData(util::GetSwapFormID(*line), input);
 
-				a_func(baseFormID, swapFormData);
-			} else {
-				logger::error("\t\t\t\tfail : [{}] (SWAP formID not found)", a_str);
-			}
-		} else {
-			logger::error("\t\t\t\tfail : [{}] (BASE formID not found)", a_str);
+			a_func(line->baseID, swapFormData);
 		}
 	}
 }
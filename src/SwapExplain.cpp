@@ -0,0 +1,37 @@
+#include "SwapExplain.h"
+
+SwapExplain::Stage::Stage(SwapExplain& a_explain, std::size_t a_line) :
+	explain(a_explain),
+	line(a_line),
+	start(std::chrono::steady_clock::now())
+{
+	explain.depth++;
+}
+
+SwapExplain::Stage::~Stage()
+{
+	explain.depth--;
+	explain.lines[line].nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+SwapExplain::Stage SwapExplain::BeginStage(std::string_view a_name)
+{
+	lines.push_back({ depth, std::string(a_name), std::nullopt });
+	return Stage(*this, lines.size() - 1);
+}
+
+void SwapExplain::Print(bool a_console) const
+{
+	const auto console = a_console ? RE::ConsoleLog::GetSingleton() : nullptr;
+
+	for (const auto& [lineDepth, text, nanoseconds] : lines) {
+		auto str = std::string(lineDepth * 2, ' ').append(text);
+		if (nanoseconds) {
+			str.append(std::format(" ({} ns)", *nanoseconds));
+		}
+		logger::info("{}", str);
+		if (console) {
+			console->PrintLine(str.c_str());
+		}
+	}
+}
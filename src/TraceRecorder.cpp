@@ -0,0 +1,104 @@
+#include "TraceRecorder.h"
+#include "RefContext.h"
+
+void TraceRecorder::Open()
+{
+	auto path = logger::log_directory();
+	if (!path) {
+		return;
+	}
+
+	*path /= Version::PROJECT;
+	*path += ".trace"sv;
+
+	file.open(*path, std::ios::binary | std::ios::trunc);
+	if (!file) {
+		logger::error("Failed to open trace file {}", path->string());
+		return;
+	}
+
+	const BOSTrace::FileHeader header{};
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	buffer.reserve(flushSize + 4096);
+	recording = true;
+
+	logger::info("Recording swap trace to {}", path->string());
+}
+
+void TraceRecorder::Flush()
+{
+	if (!recording) {
+		return;
+	}
+
+	std::scoped_lock guard(lock);
+	flush_impl();
+	file.flush();
+
+	logger::info("{} swap trace records written", records);
+}
+
+void TraceRecorder::flush_impl()
+{
+	file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+	buffer.clear();
+}
+
+void TraceRecorder::Record(const RefContext& a_context, const RE::BGSMaterialSwap* a_materialSwap, const RE::TESBoundObject* a_result, bool a_restored)
+{
+	const auto add_keywords = [](const RE::BGSKeywordForm* a_keywordForm, std::vector<BOSTrace::FormID>& a_list) {
+		for (std::uint32_t i = 0; i < a_keywordForm->numKeywords; ++i) {
+			if (const auto keyword = a_keywordForm->keywords[i]) {
+				a_list.push_back(keyword->GetFormID());
+			}
+		}
+	};
+
+	const auto ref = a_context.GetRef();
+	const auto base = a_context.GetBase();
+
+	BOSTrace::Record record;
+	record.ref = a_context.GetRefID();
+	record.base = base->GetFormID();
+	record.materialSwap = a_materialSwap ? a_materialSwap->GetFormID() : 0;
+	record.position[0] = ref->data.location.x;
+	record.position[1] = ref->data.location.y;
+	record.position[2] = ref->data.location.z;
+	record.result = a_result ? a_result->GetFormID() : 0;
+
+	if (a_context.IsCreated()) {
+		record.flags |= BOSTrace::Record::kCreated;
+	}
+	if (a_restored) {
+		record.flags |= BOSTrace::Record::kRestored;
+	}
+
+	if (const auto cell = a_context.GetCell()) {
+		record.cell = cell->GetFormID();
+		if (cell->IsExterior() && cell->worldSpace) {
+			record.worldspace = cell->worldSpace->GetFormID();
+		}
+	}
+
+	if (const auto location = a_context.GetLocation()) {
+		for (auto current = location; current; current = current->parentLoc) {
+			record.locations.push_back(current->GetFormID());
+		}
+		add_keywords(location, record.locationKeywords);
+	}
+
+	record.regions = a_context.GetCellData().regionIDs;
+
+	if (const auto keywordForm = base->As<RE::BGSKeywordForm>()) {
+		add_keywords(keywordForm, record.refKeywords);
+	}
+
+	std::scoped_lock guard(lock);
+	BOSTrace::WriteRecord(buffer, record);
+	records++;
+
+	if (buffer.size() >= flushSize) {
+		flush_impl();
+	}
+}
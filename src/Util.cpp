@@ -1,9 +1,13 @@
 #include "Util.h"
+#include "LoadErrors.h"
+#include "LoadProfiler.h"
 
 namespace util
 {
 	std::vector<std::string> split_with_regex(const std::string& a_str, const srell::regex& a_regex)
 	{
+		LoadProfiler::ScopedTimer timer(LoadProfiler::STAGE::kSplitWithRegex, a_str.size());
+
 		srell::sregex_token_iterator iter(a_str.begin(),
 			a_str.end(),
 			a_regex,
@@ -12,42 +16,53 @@ namespace util
 		return { iter, end };
 	}
 
-	RE::FormID GetFormID(const std::string& a_str)
+	RE::FormID GameFormLookup::LookupFormID(RE::FormID a_localID, std::string_view a_plugin) const
 	{
-		if (const auto splitID = string::split(a_str, "~"); splitID.size() == 2) {
-			const auto formID = string::to_num<RE::FormID>(splitID[0], true);
-			const auto& modName = splitID[1];
-			return RE::TESDataHandler::GetSingleton()->LookupFormID(formID, modName);
-		}
-		if (string::is_only_hex(a_str, true)) {
-			const auto formID = string::to_num<RE::FormID>(a_str, true);
-			if (const auto form = RE::TESForm::GetFormByID(formID); !form) {
-				logger::error("\t\tFilter [{}] INFO - unable to find form, treating filter as cell formID", a_str);
-			}
-			return formID;
-		}
-		if (const auto form = RE::TESForm::GetFormByEditorID(a_str)) {
+		return RE::TESDataHandler::GetSingleton()->LookupFormID(a_localID, a_plugin);
+	}
+
+	RE::FormID GameFormLookup::LookupEditorID(std::string_view a_editorID) const
+	{
+		if (const auto form = RE::TESForm::GetFormByEditorID(a_editorID)) {
 			return form->GetFormID();
 		}
 		return static_cast<RE::FormID>(0);
 	}
 
-	FormIDOrSet GetSwapFormID(const std::string& a_str)
+	bool GameFormLookup::IsLoaded(RE::FormID a_formID) const
+	{
+		return RE::TESForm::GetFormByID(a_formID) != nullptr;
+	}
+
+	void GameFormLookup::Report(core::ParseError a_error, std::string_view a_entry) const
 	{
-		if (a_str.contains(",")) {
-			FormIDSet set;
-			const auto IDStrs = string::split(a_str, ",");
-			set.reserve(IDStrs.size());
-			for (auto& IDStr : IDStrs) {
-				if (auto formID = GetFormID(IDStr); formID != 0) {
-					set.emplace(formID);
-				} else {
-					logger::error("\t\t\tfail : [{}] (SWAP formID not found)", IDStr);
-				}
+		const auto type = [&] {
+			switch (a_error) {
+			case core::ParseError::kBaseNotFound:
+				return LoadErrors::TYPE::kBaseNotFound;
+			case core::ParseError::kSwapNotFound:
+				return LoadErrors::TYPE::kSwapNotFound;
+			case core::ParseError::kSwapSetNotFound:
+				return LoadErrors::TYPE::kSwapSetNotFound;
+			case core::ParseError::kBaseSameAsSwap:
+				return LoadErrors::TYPE::kBaseSameAsSwap;
+			default:
+				return LoadErrors::TYPE::kFilterFormIDNotFound;
 			}
-			return set;
-		} else {
-			return GetFormID(a_str);
+		}();
+		LoadErrors::GetSingleton()->Report(type, a_entry);
+	}
+
+	RE::FormID GetFormID(const std::string& a_str)
+	{
+		return core::ResolveFormID(GameFormLookup{}, a_str);
+	}
+
+	FormIDOrSet GetSwapFormID(const core::RuleLine& a_line)
+	{
+		if (a_line.swapSet) {
+			return FormIDSet(a_line.swapIDs.begin(), a_line.swapIDs.end());
 		}
+		return a_line.swapIDs.front();
 	}
 }
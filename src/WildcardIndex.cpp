@@ -0,0 +1,124 @@
+#include "WildcardIndex.h"
+#include "LoadErrors.h"
+
+namespace FormSwap
+{
+	namespace
+	{
+		// bound object types that can be swapped
+		constexpr std::array formTypeNames{
+			std::pair{ "ACTI"sv, RE::ENUM_FORM_ID::kACTI },
+			std::pair{ "ALCH"sv, RE::ENUM_FORM_ID::kALCH },
+			std::pair{ "AMMO"sv, RE::ENUM_FORM_ID::kAMMO },
+			std::pair{ "ARMO"sv, RE::ENUM_FORM_ID::kARMO },
+			std::pair{ "BOOK"sv, RE::ENUM_FORM_ID::kBOOK },
+			std::pair{ "CONT"sv, RE::ENUM_FORM_ID::kCONT },
+			std::pair{ "DOOR"sv, RE::ENUM_FORM_ID::kDOOR },
+			std::pair{ "FLOR"sv, RE::ENUM_FORM_ID::kFLOR },
+			std::pair{ "FURN"sv, RE::ENUM_FORM_ID::kFURN },
+			std::pair{ "HAZD"sv, RE::ENUM_FORM_ID::kHAZD },
+			std::pair{ "IDLM"sv, RE::ENUM_FORM_ID::kIDLM },
+			std::pair{ "KEYM"sv, RE::ENUM_FORM_ID::kKEYM },
+			std::pair{ "LIGH"sv, RE::ENUM_FORM_ID::kLIGH },
+			std::pair{ "MISC"sv, RE::ENUM_FORM_ID::kMISC },
+			std::pair{ "MSTT"sv, RE::ENUM_FORM_ID::kMSTT },
+			std::pair{ "NOTE"sv, RE::ENUM_FORM_ID::kNOTE },
+			std::pair{ "PROJ"sv, RE::ENUM_FORM_ID::kPROJ },
+			std::pair{ "SCOL"sv, RE::ENUM_FORM_ID::kSCOL },
+			std::pair{ "STAT"sv, RE::ENUM_FORM_ID::kSTAT },
+			std::pair{ "TACT"sv, RE::ENUM_FORM_ID::kTACT },
+			std::pair{ "TERM"sv, RE::ENUM_FORM_ID::kTERM },
+			std::pair{ "WEAP"sv, RE::ENUM_FORM_ID::kWEAP }
+		};
+
+		constexpr auto keywordPrefix{ "keyword("sv };
+		constexpr auto typePrefix{ "type("sv };
+	}
+
+	bool WildcardIndex::IsWildcard(std::string_view a_key)
+	{
+		return a_key.starts_with(keywordPrefix) || a_key.starts_with(typePrefix);
+	}
+
+	void WildcardIndex::Add(const std::string& a_path, const std::string& a_str)
+	{
+		const auto formPair = string::split(a_str, "|");
+
+		const auto& key = formPair[0];
+		const auto  isKeyword = key.starts_with(keywordPrefix);
+		const auto  argBegin = isKeyword ? keywordPrefix.size() : typePrefix.size();
+		const auto  argEnd = key.find(')', argBegin);
+		if (argEnd == std::string::npos) {
+			LoadErrors::GetSingleton()->Report(LoadErrors::TYPE::kBaseNotFound, a_str);
+			return;
+		}
+		const auto arg = key.substr(argBegin, argEnd - argBegin);
+
+		std::vector<Rule>* rules = nullptr;
+		if (isKeyword) {
+			const auto keywordID = util::GetFormID(arg);
+			const auto keyword = RE::TESForm::GetFormByID<RE::BGSKeyword>(keywordID);
+			if (!keyword) {
+				LoadErrors::GetSingleton()->Report(LoadErrors::TYPE::kBaseNotFound, a_str);
+				return;
+			}
+			rules = std::addressof(keywords[keywordID]);
+			keywordFilter |= filter_bit(keywordID);
+		} else {
+			const auto it = std::ranges::find_if(formTypeNames, [&](const auto& a_pair) { return string::iequals(a_pair.first, arg); });
+			if (it == formTypeNames.end()) {
+				LoadErrors::GetSingleton()->Report(LoadErrors::TYPE::kBaseNotFound, a_str);
+				return;
+			}
+			rules = std::addressof(formTypes[std::to_underlying(it->second)]);
+		}
+
+		const auto line = core::ParseSwapFields(util::GameFormLookup{}, a_str);
+		if (!line) {
+			return;
+		}
+
+		const SwapFormData::Input input(
+			std::string(line->properties),
+			std::string(line->chance),
+			a_str,
+			a_path);
+
+		rules->push_back({ nextOrder++, SwapFormData(util::GetSwapFormID(*line), input) });
+	}
+
+	std::size_t WildcardIndex::size() const
+	{
+		std::size_t count = 0;
+		ForEachRule([&](const SwapFormData&) { count++; });
+		return count;
+	}
+
+	std::size_t WildcardIndex::ResolveSwapObjects()
+	{
+		std::size_t rejected = 0;
+
+		const auto resolve = [&](auto& a_map) {
+			std::vector<std::uint32_t> emptyKeys;
+			for (auto& [key, rules] : a_map) {
+				rejected += std::erase_if(rules, [](Rule& a_rule) { return !a_rule.data.ResolveSwapObjects(); });
+				if (rules.empty()) {
+					emptyKeys.push_back(key);
+				}
+			}
+			for (const auto key : emptyKeys) {
+				a_map.erase(key);
+			}
+		};
+
+		resolve(keywords);
+		resolve(formTypes);
+
+		keywordFilter = 0;
+		for (const auto keywordID : keywords | std::views::keys) {
+			keywordFilter |= filter_bit(keywordID);
+		}
+
+		return rejected;
+	}
+}
@@ -1,15 +1,44 @@
+#include "CellDataCache.h"
+#include "ConsoleCommands.h"
+#include "FilterProfile.h"
 #include "Hooks.h"
 #include "Manager.h"
+#include "RefContext.h"
+#include "Serialization.h"
+#include "Settings.h"
+#include "ShadowEval.h"
+#include "TraceRecorder.h"
 
 void MessageHandler(F4SE::MessagingInterface::Message* a_message)
 {
 	switch (a_message->type) {
 	case F4SE::MessagingInterface::kPostLoad:
 		BaseObjectSwapper::Install();
+		ConsoleCommands::Install();
 		break;
 	case F4SE::MessagingInterface::kGameDataReady:
 		FormSwap::Manager::GetSingleton()->PrintConflicts();
 		break;
+	case F4SE::MessagingInterface::kPreLoadGame:
+		CellDataCache::GetSingleton()->Reset();
+		TraceRecorder::GetSingleton()->Flush();
+		break;
+	case F4SE::MessagingInterface::kPostLoadGame:
+		RefContext::LogStats();
+		BaseObjectSwapper::LogStats();
+		CellDataCache::GetSingleton()->LogStats();
+		ShadowEval::GetSingleton()->LogStats();
+		TraceRecorder::GetSingleton()->Flush();
+		FilterProfile::GetSingleton()->Save();
+		FormSwap::Manager::GetSingleton()->LogMemoryReport();
+		FormSwap::Manager::GetSingleton()->PrintConflicts();
+		spdlog::default_logger()->flush();
+		break;
+	case F4SE::MessagingInterface::kPostSaveGame:
+		TraceRecorder::GetSingleton()->Flush();
+		FilterProfile::GetSingleton()->Save();
+		spdlog::default_logger()->flush();
+		break;
 	default:
 		break;
 	}
@@ -24,14 +53,19 @@ void InitializeLog()
 
 	*path /= Version::PROJECT;
 	*path += ".log"sv;
-	auto sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(path->string(), true);
+	auto sink = std::make_shared<spdlog::sinks::basic_file_sink_st>(path->string(), true);
 
-	auto log = std::make_shared<spdlog::logger>("global log"s, std::move(sink));
+	// lines are queued in a bounded ring buffer and written in batches by one worker thread
+	// the file is flushed on errors, every few seconds, at the end of LoadForms and after saves and loads
+	// no shutdown flush, joining the worker from a DLL exit handler runs under the loader lock
+	spdlog::init_thread_pool(8192, 1);
+	auto log = std::make_shared<spdlog::async_logger>("global log"s, std::move(sink), spdlog::thread_pool(), spdlog::async_overflow_policy::block);
 
 	log->set_level(spdlog::level::info);
-	log->flush_on(spdlog::level::info);
+	log->flush_on(spdlog::level::err);
 
 	spdlog::set_default_logger(std::move(log));
+	spdlog::flush_every(std::chrono::seconds(5));
 	spdlog::set_pattern("[%H:%M:%S:%e] %v"s);
 
 	logger::info(FMT_STRING("{} v{}"), Version::PROJECT, Version::NAME);
@@ -59,8 +93,20 @@ extern "C" DLLEXPORT bool F4SEAPI F4SEPlugin_Load(const F4SE::LoadInterface* a_f
 
 	InitializeLog();
 
+	Settings::GetSingleton()->Load();
+	ShadowEval::GetSingleton()->Start();
+	if (Settings::GetSingleton()->recordTrace) {
+		TraceRecorder::GetSingleton()->Open();
+	}
+
 	const auto messaging = F4SE::GetMessagingInterface();
 	messaging->RegisterListener(MessageHandler);
 
+	const auto serialization = F4SE::GetSerializationInterface();
+	serialization->SetUniqueID(Serialization::kBOS);
+	serialization->SetSaveCallback(Serialization::SaveCallback);
+	serialization->SetLoadCallback(Serialization::LoadCallback);
+	serialization->SetRevertCallback(Serialization::RevertCallback);
+
 	return true;
 }
@@ -0,0 +1,178 @@
+#include "Core/ShardedTable.h"
+#include "TraceReplay.h"
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+// Hammers the swap_base read path from N threads with trace records standing in for refs.
+// Per call : swap decision lookup, rule evaluation, decision insert on a swap, then the
+// SetObjectReference leveled item check, the same lock pattern as the plugin hooks.
+// Every pass over the trace uses fresh ref IDs, passes are split between threads so the
+// total work is the same for every thread count.
+//
+// What runs is plugin code : the decision stores are core::ShardedTable, and conditional
+// entries are evaluated by core::CompiledFilterList through TraceReplay::RuleSet. What doesn't :
+// the engine queries behind each atom (trace records answer them from vectors), leveled list
+// picks, properties and chance rolls. So the figures measure lock layout and filter evaluation
+// cost, not the engine's own scaling.
+namespace
+{
+	using BOSTrace::FormID;
+
+	struct Workload
+	{
+		const TraceReplay::RuleSet&           ruleSet;
+		const std::vector<BOSTrace::Record>& records;
+		std::uint32_t                         passes;
+	};
+
+	// no decision store, rule evaluation only
+	struct NoStore
+	{
+		static constexpr auto name{ "rules only" };
+
+		FormID find(FormID) const { return 0; }
+		void   insert(FormID, FormID) {}
+		bool   is_leveled(FormID) const { return false; }
+	};
+
+	template <std::size_t Shards>
+	struct LockedStore
+	{
+		static constexpr auto name{ Shards == 1 ? "single lock" : "sharded" };
+
+		FormID find(FormID a_refID) const
+		{
+			return decisions.read(a_refID, [&](const auto& a_decisions) {
+				const auto it = a_decisions.find(a_refID);
+				return it != a_decisions.end() ? it->second : 0;
+			});
+		}
+
+		void insert(FormID a_refID, FormID a_swapID)
+		{
+			decisions.write(a_refID, [&](auto& a_decisions) { a_decisions.insert_or_assign(a_refID, a_swapID); });
+		}
+
+		bool is_leveled(FormID a_refID) const
+		{
+			return leveledRefs.read(a_refID, [&](const auto& a_refs) { return a_refs.contains(a_refID); });
+		}
+
+		// members
+		core::ShardedTable<std::unordered_map<FormID, FormID>, Shards> decisions{};
+		core::ShardedTable<std::unordered_set<FormID>, Shards>         leveledRefs{};
+	};
+
+	template <class Store>
+	std::uint64_t hook_call(Store& a_store, const TraceReplay::RuleSet& a_ruleSet, const BOSTrace::Record& a_record, FormID a_refID)
+	{
+		std::uint64_t swapped = 0;
+		if (a_store.find(a_refID) == 0) {
+			const auto result = a_ruleSet.Evaluate(a_record);
+			if (const auto swapID = result.expected != 0 ? result.expected : (result.rule ? result.rule->swaps.front() : 0); swapID != 0) {
+				a_store.insert(a_refID, swapID);
+				swapped = 1;
+			}
+		}
+		return swapped + (a_store.is_leveled(a_refID) ? 1 : 0);
+	}
+
+	template <class Store>
+	double run(const Workload& a_workload, std::uint32_t a_threads)
+	{
+		Store                      store;
+		std::atomic<std::uint64_t> checksum{ 0 };
+
+		const auto start = std::chrono::steady_clock::now();
+		{
+			std::vector<std::jthread> threads;
+			for (std::uint32_t t = 0; t < a_threads; ++t) {
+				threads.emplace_back([&, t] {
+					std::uint64_t local = 0;
+					for (std::uint32_t pass = t; pass < a_workload.passes; pass += a_threads) {
+						for (const auto& record : a_workload.records) {
+							local += hook_call(store, a_workload.ruleSet, record, record.ref ^ (pass << 24));
+						}
+					}
+					checksum.fetch_add(local, std::memory_order_relaxed);
+				});
+			}
+		}
+		const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		const auto calls = static_cast<double>(a_workload.records.size()) * a_workload.passes;
+		return calls / elapsed / 1000000.0;
+	}
+
+	template <class Store>
+	void report(const Workload& a_workload, const std::vector<std::uint32_t>& a_threadCounts)
+	{
+		std::cout << Store::name << "\n";
+
+		double baseline = 0.0;
+		for (const auto threads : a_threadCounts) {
+			const auto throughput = run<Store>(a_workload, threads);
+			if (threads == a_threadCounts.front()) {
+				baseline = throughput;
+			}
+			std::cout << "\t" << std::setw(2) << threads << " threads : "
+					  << std::fixed << std::setprecision(2) << throughput << " M calls/s, "
+					  << throughput / baseline << "x\n";
+		}
+	}
+}
+
+int main(int a_argc, char* a_argv[])
+{
+	if (a_argc < 5) {
+		std::cerr << "usage: " << a_argv[0] << " <Data folder> <plugins.txt> <trace> [--threads 32] [--passes 64] <_SWAP.ini or folder ...>\n";
+		return 2;
+	}
+
+	const std::filesystem::path dataDir(a_argv[1]);
+	const std::filesystem::path tracePath(a_argv[3]);
+
+	std::uint32_t                      maxThreads = 32;
+	std::uint32_t                      passes = 64;
+	std::vector<std::filesystem::path> configs;
+	for (int i = 4; i < a_argc; ++i) {
+		const std::string_view arg(a_argv[i]);
+		if (arg == "--threads" && i + 1 < a_argc) {
+			maxThreads = static_cast<std::uint32_t>(std::stoul(a_argv[++i]));
+		} else if (arg == "--passes" && i + 1 < a_argc) {
+			passes = static_cast<std::uint32_t>(std::stoul(a_argv[++i]));
+		} else {
+			configs.emplace_back(arg);
+		}
+	}
+
+	const auto records = TraceReplay::ReadTrace(tracePath);
+	if (!records || records->empty()) {
+		std::cerr << tracePath.string() << ": not a swap trace, or empty\n";
+		return 2;
+	}
+
+	const auto loadOrder = PluginIndexer::ReadLoadOrder(a_argv[2], dataDir);
+	const auto index = PluginIndexer::Index::Build(dataDir, loadOrder);
+	const auto ruleSet = TraceReplay::RuleSet::Load(index, configs);
+
+	std::cout << records->size() << " trace records x " << passes << " passes, " << ruleSet.size() << " swap rules\n";
+
+	std::vector<std::uint32_t> threadCounts;
+	for (std::uint32_t threads = 1; threads <= maxThreads; threads *= 2) {
+		threadCounts.push_back(threads);
+	}
+
+	const Workload workload{ ruleSet, *records, passes };
+	report<NoStore>(workload, threadCounts);
+	report<LockedStore<1>>(workload, threadCounts);
+	report<LockedStore<16>>(workload, threadCounts);
+
+	return 0;
+}
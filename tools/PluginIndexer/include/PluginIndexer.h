@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Offline editorID -> formID index built from memory mapped ESM/ESP/ESL files.
+// Only record headers and EDID subrecords are read; compressed records are inflated up to their EDID.
+namespace PluginIndexer
+{
+	using FormID = std::uint32_t;
+
+	struct PluginInfo
+	{
+		std::string              name{};
+		std::vector<std::string> masters{};
+		bool                     light{ false };
+		std::uint32_t            loadIndex{ 0 };  // 00-FD, or FE light index
+		std::size_t              records{ 0 };
+		std::size_t              compressedRecords{ 0 };
+		std::size_t              inflateErrors{ 0 };  // compressed records whose editorID couldn't be read
+		bool                     valid{ false };
+	};
+
+	class Index
+	{
+	public:
+		// a_loadOrder : plugin file names, in load order
+		static Index Build(const std::filesystem::path& a_dataDir, std::span<const std::string> a_loadOrder, std::size_t a_threads = 0);
+
+		// mirrors util::GetFormID : "0x123~Plugin.esp", "0x01000123" or "EditorID"
+		[[nodiscard]] std::optional<FormID> Resolve(std::string_view a_str) const;
+		// mirrors the condition filter lookup : hex formIDs are kept even if no plugin has them, like util::GetFormID,
+		// so runtime (FF) forms match the formIDs recorded in a trace
+		[[nodiscard]] std::optional<FormID> ResolveFilter(std::string_view a_str) const;
+
+		[[nodiscard]] std::optional<FormID> LookupEditorID(std::string_view a_editorID) const;
+		[[nodiscard]] std::optional<FormID> LookupFormID(FormID a_localFormID, std::string_view a_plugin) const;
+		[[nodiscard]] bool                  Contains(FormID a_formID) const;
+		// record signature (to_signature("STAT")) of the last plugin defining a_formID, 0 if none does
+		[[nodiscard]] std::uint32_t         GetFormType(FormID a_formID) const;
+		// false if some compressed records couldn't be inflated, editorIDs missing from the index are then unknown
+		[[nodiscard]] bool                  HasAllEditorIDs() const { return inflateErrors == 0; }
+
+		[[nodiscard]] const std::vector<PluginInfo>& GetPlugins() const { return plugins; }
+		[[nodiscard]] std::size_t                    GetEditorIDCount() const { return editorIDs.size(); }
+		[[nodiscard]] std::size_t                    GetFormCount() const { return formTypes.size(); }
+
+	private:
+		struct Record
+		{
+			std::uint32_t    ownerIndex;  // index into the plugin's master list, masters.size() == self
+			FormID           localFormID;
+			std::uint32_t    type;
+			std::string_view editorID;  // points into the mapped file, valid until the scan is merged
+		};
+
+		struct ScanResult;
+
+		static void ScanPlugin(const std::filesystem::path& a_path, ScanResult& a_result);
+
+		[[nodiscard]] std::optional<FormID> ToRuntimeFormID(const PluginInfo& a_owner, FormID a_localFormID) const;
+
+		// members
+		std::vector<PluginInfo>                    plugins{};
+		std::unordered_map<std::string, std::size_t> pluginIndices{};  // lowercase name
+		std::unordered_map<std::string, FormID>      editorIDs{};      // lowercase editorID
+		std::unordered_map<FormID, std::uint32_t>    formTypes{};  // record signature
+		std::size_t                                  inflateErrors{ 0 };
+	};
+
+	std::string to_lower(std::string_view a_str);
+
+	// "STAT" -> the record signature as read from the file, case insensitive, 0 if not 4 characters
+	std::uint32_t to_signature(std::string_view a_type);
+
+	// plugins.txt style : one plugin per line, '*' prefix and '#' comments allowed
+	std::vector<std::string> ReadLoadOrder(const std::filesystem::path& a_path, const std::filesystem::path& a_dataDir);
+}
@@ -0,0 +1,390 @@
+#include "PluginIndexer.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <thread>
+
+#include <mmio/mmio.hpp>
+#include <zlib.h>
+
+namespace PluginIndexer
+{
+	namespace
+	{
+		constexpr std::size_t headerSize = 24;  // record and GRUP headers
+
+		enum : std::uint32_t
+		{
+			kMaster = 0x1,
+			kLight = 0x200,
+			kCompressed = 0x40000
+		};
+
+		constexpr std::array implicitPlugins{
+			"Fallout4.esm",
+			"DLCRobot.esm",
+			"DLCworkshop01.esm",
+			"DLCCoast.esm",
+			"DLCworkshop02.esm",
+			"DLCworkshop03.esm",
+			"DLCNukaWorld.esm",
+			"DLCUltraHighResolution.esm"
+		};
+
+		template <class T>
+		T read(const std::uint8_t* a_data)
+		{
+			T value;
+			std::memcpy(&value, a_data, sizeof(T));
+			return value;
+		}
+
+		bool is_type(const std::uint8_t* a_data, const char (&a_type)[5])
+		{
+			return std::memcmp(a_data, a_type, 4) == 0;
+		}
+
+		std::string_view read_zstring(const std::uint8_t* a_data, std::size_t a_size)
+		{
+			const auto str = reinterpret_cast<const char*>(a_data);
+			return { str, strnlen(str, a_size) };
+		}
+
+		// compressed record data is the decompressed size followed by a zlib stream
+		// EDID is always the first subrecord, so only the head of the stream is inflated
+		// nullopt on a corrupt stream, an empty string if the record has no EDID
+		std::optional<std::string> inflate_editorID(const std::uint8_t* a_data, std::size_t a_size)
+		{
+			if (a_size < 4) {
+				return std::nullopt;
+			}
+
+			std::array<std::uint8_t, 6 + 512> head{};
+
+			z_stream stream{};
+			if (inflateInit(&stream) != Z_OK) {
+				return std::nullopt;
+			}
+			stream.next_in = const_cast<Bytef*>(a_data + 4);
+			stream.avail_in = static_cast<uInt>(a_size - 4);
+			stream.next_out = head.data();
+			stream.avail_out = static_cast<uInt>(head.size());
+
+			const auto result = inflate(&stream, Z_SYNC_FLUSH);
+			const auto inflated = head.size() - stream.avail_out;
+			inflateEnd(&stream);
+
+			if (result != Z_OK && result != Z_STREAM_END) {
+				return std::nullopt;
+			}
+			if (inflated < 6 || !is_type(head.data(), "EDID")) {
+				return std::string{};
+			}
+			const auto edidSize = std::min<std::size_t>(read<std::uint16_t>(head.data() + 4), inflated - 6);
+			return std::string(read_zstring(head.data() + 6, edidSize));
+		}
+
+		bool is_only_hex(std::string_view a_str)
+		{
+			if (a_str.starts_with("0x") || a_str.starts_with("0X")) {
+				a_str.remove_prefix(2);
+			}
+			return !a_str.empty() && std::ranges::all_of(a_str, [](char a_ch) { return std::isxdigit(static_cast<unsigned char>(a_ch)) != 0; });
+		}
+
+		std::optional<FormID> to_formID(std::string_view a_str)
+		{
+			if (a_str.starts_with("0x") || a_str.starts_with("0X")) {
+				a_str.remove_prefix(2);
+			}
+			FormID formID = 0;
+			if (const auto [ptr, ec] = std::from_chars(a_str.data(), a_str.data() + a_str.size(), formID, 16); ec != std::errc{}) {
+				return std::nullopt;
+			}
+			return formID;
+		}
+
+		std::string_view trim(std::string_view a_str)
+		{
+			while (!a_str.empty() && std::isspace(static_cast<unsigned char>(a_str.front()))) {
+				a_str.remove_prefix(1);
+			}
+			while (!a_str.empty() && std::isspace(static_cast<unsigned char>(a_str.back()))) {
+				a_str.remove_suffix(1);
+			}
+			return a_str;
+		}
+	}
+
+	struct Index::ScanResult
+	{
+		mmio::mapped_file_source file{};
+		PluginInfo               info{};
+		std::vector<Record>      records{};
+		std::deque<std::string>  inflatedEditorIDs{};  // editorIDs of compressed records, Record::editorID points here
+	};
+
+	std::string to_lower(std::string_view a_str)
+	{
+		std::string result(a_str);
+		std::ranges::transform(result, result.begin(), [](unsigned char a_ch) { return static_cast<char>(std::tolower(a_ch)); });
+		return result;
+	}
+
+	std::uint32_t to_signature(std::string_view a_type)
+	{
+		if (a_type.size() != 4) {
+			return 0;
+		}
+		std::array<char, 4> chars{};
+		std::ranges::transform(a_type, chars.begin(), [](unsigned char a_ch) { return static_cast<char>(std::toupper(a_ch)); });
+		return read<std::uint32_t>(reinterpret_cast<const std::uint8_t*>(chars.data()));
+	}
+
+	std::vector<std::string> ReadLoadOrder(const std::filesystem::path& a_path, const std::filesystem::path& a_dataDir)
+	{
+		std::vector<std::string> loadOrder;
+
+		// base game masters are implicit and never listed in plugins.txt
+		for (const auto& plugin : implicitPlugins) {
+			if (std::filesystem::exists(a_dataDir / plugin)) {
+				loadOrder.emplace_back(plugin);
+			}
+		}
+
+		std::ifstream file(a_path);
+		for (std::string line; std::getline(file, line);) {
+			auto name = trim(line);
+			if (name.empty() || name.starts_with('#')) {
+				continue;
+			}
+			if (name.starts_with('*')) {
+				name.remove_prefix(1);
+			}
+			const auto lower = to_lower(name);
+			if (std::ranges::none_of(loadOrder, [&](const auto& a_plugin) { return to_lower(a_plugin) == lower; })) {
+				loadOrder.emplace_back(name);
+			}
+		}
+
+		return loadOrder;
+	}
+
+	void Index::ScanPlugin(const std::filesystem::path& a_path, ScanResult& a_result)
+	{
+		auto& [file, info, records, inflatedEditorIDs] = a_result;
+
+		if (!file.open(a_path) || !file.is_open()) {
+			return;
+		}
+
+		const auto data = reinterpret_cast<const std::uint8_t*>(file.data());
+		const auto size = file.size();
+
+		if (size < headerSize || !is_type(data, "TES4")) {
+			return;
+		}
+
+		// file header : flags and masters
+		const auto tes4Size = read<std::uint32_t>(data + 4);
+		const auto tes4Flags = read<std::uint32_t>(data + 8);
+		if (headerSize + tes4Size > size) {
+			return;
+		}
+
+		auto ext = to_lower(a_path.extension().string());
+		info.light = (tes4Flags & kLight) != 0 || ext == ".esl";
+
+		for (std::size_t pos = headerSize; pos + 6 <= headerSize + tes4Size;) {
+			const auto subSize = read<std::uint16_t>(data + pos + 4);
+			if (is_type(data + pos, "MAST")) {
+				info.masters.emplace_back(read_zstring(data + pos + 6, subSize));
+			}
+			pos += 6 + subSize;
+		}
+
+		const auto selfIndex = static_cast<std::uint32_t>(info.masters.size());
+
+		records.reserve(size / 256);
+
+		// groups are nested but contiguous, so stepping over GRUP headers visits every record
+		for (std::size_t pos = headerSize + tes4Size; pos + headerSize <= size;) {
+			if (is_type(data + pos, "GRUP")) {
+				pos += headerSize;
+				continue;
+			}
+
+			const auto dataSize = read<std::uint32_t>(data + pos + 4);
+			const auto flags = read<std::uint32_t>(data + pos + 8);
+			const auto formID = read<std::uint32_t>(data + pos + 12);
+
+			const auto recordData = pos + headerSize;
+			if (recordData + dataSize > size) {
+				break;
+			}
+
+			info.records++;
+
+			Record record{ std::min(formID >> 24, selfIndex), formID & 0x00FFFFFF, read<std::uint32_t>(data + pos), {} };
+
+			if (flags & kCompressed) {
+				info.compressedRecords++;
+				if (auto editorID = inflate_editorID(data + recordData, dataSize); !editorID) {
+					info.inflateErrors++;
+				} else if (!editorID->empty()) {
+					record.editorID = inflatedEditorIDs.emplace_back(std::move(*editorID));
+				}
+			} else if (dataSize >= 6 && is_type(data + recordData, "EDID")) {  // EDID is always the first subrecord
+				const auto edidSize = std::min<std::size_t>(read<std::uint16_t>(data + recordData + 4), dataSize - 6);
+				record.editorID = read_zstring(data + recordData + 6, edidSize);
+			}
+
+			records.push_back(record);
+
+			pos = recordData + dataSize;
+		}
+
+		info.valid = true;
+	}
+
+	Index Index::Build(const std::filesystem::path& a_dataDir, std::span<const std::string> a_loadOrder, std::size_t a_threads)
+	{
+		std::vector<ScanResult> results(a_loadOrder.size());
+
+		if (a_threads == 0) {
+			a_threads = std::max(1u, std::thread::hardware_concurrency());
+		}
+		a_threads = std::min(a_threads, a_loadOrder.size());
+
+		std::atomic_size_t next{ 0 };
+		{
+			std::vector<std::jthread> workers;
+			workers.reserve(a_threads);
+			for (std::size_t i = 0; i < a_threads; ++i) {
+				workers.emplace_back([&] {
+					for (auto idx = next++; idx < a_loadOrder.size(); idx = next++) {
+						results[idx].info.name = a_loadOrder[idx];
+						ScanPlugin(a_dataDir / a_loadOrder[idx], results[idx]);
+					}
+				});
+			}
+		}
+
+		// assign load slots, then merge in load order so later plugins win
+		Index index;
+		index.plugins.reserve(results.size());
+
+		std::uint32_t regularIndex = 0;
+		std::uint32_t lightIndex = 0;
+		for (auto& result : results) {
+			auto& info = result.info;
+			if (info.valid) {
+				info.loadIndex = info.light ? lightIndex++ : regularIndex++;
+			}
+			index.pluginIndices.emplace(to_lower(info.name), index.plugins.size());
+			index.plugins.push_back(info);
+		}
+
+		for (std::size_t i = 0; i < results.size(); ++i) {
+			const auto& [file, info, records, inflatedEditorIDs] = results[i];
+			if (!info.valid) {
+				continue;
+			}
+			index.inflateErrors += info.inflateErrors;
+
+			std::vector<const PluginInfo*> owners;
+			owners.reserve(info.masters.size() + 1);
+			for (const auto& master : info.masters) {
+				const auto it = index.pluginIndices.find(to_lower(master));
+				owners.push_back(it != index.pluginIndices.end() && index.plugins[it->second].valid ? &index.plugins[it->second] : nullptr);
+			}
+			owners.push_back(&index.plugins[i]);
+
+			index.formTypes.reserve(index.formTypes.size() + records.size());
+			for (const auto& record : records) {
+				const auto owner = owners[record.ownerIndex];
+				if (!owner) {
+					continue;
+				}
+				if (const auto formID = index.ToRuntimeFormID(*owner, record.localFormID)) {
+					index.formTypes.insert_or_assign(*formID, record.type);
+					if (!record.editorID.empty()) {
+						index.editorIDs.insert_or_assign(to_lower(record.editorID), *formID);
+					}
+				}
+			}
+		}
+
+		return index;
+	}
+
+	std::optional<FormID> Index::ToRuntimeFormID(const PluginInfo& a_owner, FormID a_localFormID) const
+	{
+		if (!a_owner.valid) {
+			return std::nullopt;
+		}
+		if (a_owner.light) {
+			return 0xFE000000 | (a_owner.loadIndex << 12) | (a_localFormID & 0xFFF);
+		}
+		return (a_owner.loadIndex << 24) | (a_localFormID & 0x00FFFFFF);
+	}
+
+	std::optional<FormID> Index::Resolve(std::string_view a_str) const
+	{
+		a_str = trim(a_str);
+
+		if (const auto pos = a_str.find('~'); pos != std::string_view::npos) {
+			const auto formID = to_formID(a_str.substr(0, pos));
+			return formID ? LookupFormID(*formID, a_str.substr(pos + 1)) : std::nullopt;
+		}
+		if (is_only_hex(a_str)) {
+			const auto formID = to_formID(a_str);
+			return formID && Contains(*formID) ? formID : std::nullopt;
+		}
+		return LookupEditorID(a_str);
+	}
+
+	std::optional<FormID> Index::ResolveFilter(std::string_view a_str) const
+	{
+		a_str = trim(a_str);
+
+		if (!a_str.contains('~') && is_only_hex(a_str)) {
+			return to_formID(a_str);
+		}
+		return Resolve(a_str);
+	}
+
+	std::optional<FormID> Index::LookupEditorID(std::string_view a_editorID) const
+	{
+		if (const auto it = editorIDs.find(to_lower(a_editorID)); it != editorIDs.end()) {
+			return it->second;
+		}
+		return std::nullopt;
+	}
+
+	std::optional<FormID> Index::LookupFormID(FormID a_localFormID, std::string_view a_plugin) const
+	{
+		if (const auto it = pluginIndices.find(to_lower(a_plugin)); it != pluginIndices.end()) {
+			if (const auto formID = ToRuntimeFormID(plugins[it->second], a_localFormID); formID && Contains(*formID)) {
+				return formID;
+			}
+		}
+		return std::nullopt;
+	}
+
+	bool Index::Contains(FormID a_formID) const
+	{
+		return formTypes.contains(a_formID);
+	}
+
+	std::uint32_t Index::GetFormType(FormID a_formID) const
+	{
+		const auto it = formTypes.find(a_formID);
+		return it != formTypes.end() ? it->second : 0;
+	}
+}
@@ -0,0 +1,192 @@
+#include "PluginIndexer.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+	std::vector<std::string_view> split(std::string_view a_str, char a_delimiter)
+	{
+		std::vector<std::string_view> result;
+		for (std::size_t pos = 0;;) {
+			const auto next = a_str.find(a_delimiter, pos);
+			result.push_back(a_str.substr(pos, next - pos));
+			if (next == std::string_view::npos) {
+				break;
+			}
+			pos = next + 1;
+		}
+		return result;
+	}
+
+	// commas inside parentheses belong to spatial filters
+	std::vector<std::string_view> split_conditions(std::string_view a_str)
+	{
+		std::vector<std::string_view> result;
+		std::size_t                   start = 0;
+		std::int32_t                  depth = 0;
+		for (std::size_t i = 0; i < a_str.size(); ++i) {
+			if (a_str[i] == '(') {
+				depth++;
+			} else if (a_str[i] == ')') {
+				depth--;
+			} else if (a_str[i] == ',' && depth == 0) {
+				result.push_back(a_str.substr(start, i - start));
+				start = i + 1;
+			}
+		}
+		result.push_back(a_str.substr(start));
+		return result;
+	}
+
+	std::string_view trim(std::string_view a_str)
+	{
+		const auto first = a_str.find_first_not_of(" \t\r\n");
+		if (first == std::string_view::npos) {
+			return {};
+		}
+		return a_str.substr(first, a_str.find_last_not_of(" \t\r\n") - first + 1);
+	}
+
+	bool is_editorID(std::string_view a_str)
+	{
+		a_str = trim(a_str);
+		if (a_str.contains('~')) {
+			return false;
+		}
+		if (a_str.starts_with("0x") || a_str.starts_with("0X")) {
+			a_str.remove_prefix(2);
+		}
+		return !std::ranges::all_of(a_str, [](char a_ch) { return std::isxdigit(static_cast<unsigned char>(a_ch)) != 0; });
+	}
+
+	// same checks as LoadForms, minus anything that needs loaded forms
+	std::size_t validate_ini(const PluginIndexer::Index& a_index, const std::filesystem::path& a_path)
+	{
+		std::ifstream file(a_path);
+		if (!file) {
+			std::cerr << a_path.string() << ": couldn't read INI\n";
+			return 1;
+		}
+
+		std::size_t failures = 0;
+		std::size_t entries = 0;
+
+		const auto fail = [&](std::size_t a_line, std::string_view a_reason, std::string_view a_entry) {
+			// the editorID may belong to a compressed record that couldn't be read
+			if (!a_index.HasAllEditorIDs() && is_editorID(a_entry)) {
+				std::cout << a_path.string() << ":" << a_line << ": " << a_reason << ", unknown (unreadable compressed records) [" << a_entry << "]\n";
+				return;
+			}
+			std::cout << a_path.string() << ":" << a_line << ": " << a_reason << " [" << a_entry << "]\n";
+			failures++;
+		};
+
+		std::string section;
+		bool        swapSection = false;
+
+		std::size_t lineNum = 0;
+		for (std::string line; std::getline(file, line);) {
+			lineNum++;
+
+			auto entry = trim(line);
+			if (entry.empty() || entry.starts_with(';') || entry.starts_with('#')) {
+				continue;
+			}
+
+			if (entry.starts_with('[') && entry.ends_with(']')) {
+				section = entry.substr(1, entry.size() - 2);
+
+				const auto splitSection = split(section, '|');
+				swapSection = splitSection[0] != "Transforms" && splitSection[0] != "Properties";
+
+				if (splitSection.size() > 1) {
+					for (auto condition : split_conditions(splitSection[1])) {
+						condition = trim(condition);
+						if (condition.starts_with('-')) {
+							condition.remove_prefix(1);
+						}
+						if (condition.starts_with("radius(") || condition.starts_with("box(") || condition.starts_with("cells(")) {
+							const auto args = condition.substr(condition.find('(') + 1);
+							if (const auto worldspace = trim(args.substr(0, args.find_first_of(",)"))); !a_index.Resolve(worldspace)) {
+								fail(lineNum, "spatial filter worldspace not found", condition);
+							}
+							continue;
+						}
+						if (!a_index.Resolve(condition)) {
+							std::cout << a_path.string() << ":" << lineNum << ": filter form not found, treated as keyword or cell editorID [" << condition << "]\n";
+						}
+					}
+				}
+				continue;
+			}
+
+			entry = trim(entry.substr(0, entry.find('=')));
+			entries++;
+
+			const auto formPair = split(entry, '|');
+			if (!a_index.Resolve(formPair[0])) {
+				fail(lineNum, "BASE formID not found", entry);
+				continue;
+			}
+
+			if (swapSection) {
+				if (formPair.size() < 2) {
+					fail(lineNum, "missing SWAP formID", entry);
+					continue;
+				}
+				for (const auto swapForm : split(formPair[1], ',')) {
+					if (!a_index.Resolve(swapForm)) {
+						fail(lineNum, "SWAP formID not found", swapForm);
+					}
+				}
+			}
+		}
+
+		std::cout << a_path.string() << ": " << entries << " entries, " << failures << " failures\n";
+
+		return failures;
+	}
+}
+
+int main(int a_argc, char* a_argv[])
+{
+	if (a_argc < 3) {
+		std::cerr << "usage: " << a_argv[0] << " <Data folder> <plugins.txt> [_SWAP.ini ...]\n";
+		return 2;
+	}
+
+	const std::filesystem::path dataDir(a_argv[1]);
+	const auto                  loadOrder = PluginIndexer::ReadLoadOrder(a_argv[2], dataDir);
+
+	const auto start = std::chrono::steady_clock::now();
+	const auto index = PluginIndexer::Index::Build(dataDir, loadOrder);
+	const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+	std::size_t compressed = 0;
+	std::size_t inflateErrors = 0;
+	for (const auto& plugin : index.GetPlugins()) {
+		if (!plugin.valid) {
+			std::cerr << "couldn't read " << plugin.name << "\n";
+		}
+		if (plugin.inflateErrors > 0) {
+			std::cerr << plugin.name << ": " << plugin.inflateErrors << " compressed records couldn't be inflated\n";
+		}
+		compressed += plugin.compressedRecords;
+		inflateErrors += plugin.inflateErrors;
+	}
+
+	std::cout << "indexed " << loadOrder.size() << " plugins in " << elapsed.count() << " ms : "
+			  << index.GetFormCount() << " forms, " << index.GetEditorIDCount() << " editorIDs, "
+			  << compressed << " compressed records (" << inflateErrors << " unreadable)\n";
+
+	std::size_t failures = 0;
+	for (int i = 3; i < a_argc; ++i) {
+		failures += validate_ini(index, a_argv[i]);
+	}
+
+	return failures == 0 ? 0 : 1;
+}
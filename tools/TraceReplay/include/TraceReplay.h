@@ -0,0 +1,119 @@
+#pragma once
+
+#include "Core/CompiledFilters.h"
+#include "PluginIndexer.h"
+#include "TraceFormat.h"
+
+#include <array>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Replays a swap trace against a set of _SWAP.ini files, without the game.
+// Mirrors the rule selection in Manager::GetSwapData : reference swaps, then conditional form swaps, then form swaps,
+// then keyword(...) and type(...) wildcard swaps, last entry wins. Conditional entries are evaluated by core::CompiledFilterList, the same code as the plugin. Chance rolls and random picks from swap sets need the game's RNG, so rules using them are
+// reported as non-deterministic instead of being rolled. Leveled list targets are reported as is.
+namespace TraceReplay
+{
+	using BOSTrace::FormID;
+
+	struct Rule
+	{
+		std::string         record{};
+		std::string         path{};
+		std::vector<FormID> swaps{};
+		bool                chance{ false };  // chance below 100
+	};
+
+	struct Filter
+	{
+		enum class TYPE
+		{
+			kForm,        // location, region, keyword or cell, editorIDs are resolved through the plugin index
+			kUnresolved,  // editorID not found in any plugin, or a spatial filter that failed to parse, never matches
+			kRadius2D,
+			kRadius3D,
+			kBox
+		};
+
+		[[nodiscard]] bool IsValid(const BOSTrace::Record& a_record) const;
+
+		bool operator==(const Filter&) const = default;
+
+		// members
+		TYPE                 type{ TYPE::kForm };
+		FormID               formID{ 0 };  // form, resolved editorID or spatial worldspace
+		std::array<float, 3> min{};
+		std::array<float, 3> max{};
+		std::array<float, 3> center{};
+		float                radiusSquared{ 0.0f };
+	};
+
+	// rules[i] applies if compiled entry i passes
+	struct ConditionalList
+	{
+		// members
+		std::vector<Rule>                rules{};
+		core::CompiledFilterList<Filter> compiled{};
+	};
+
+	struct Result
+	{
+		enum class STATUS
+		{
+			kNone,      // no rule applies
+			kMatch,     // deterministic rule, same result as recorded
+			kMismatch,  // deterministic rule, different result
+			kRandom,    // winning rule depends on a chance roll or set pick
+			kRestored   // recorded result came from the co-save
+		};
+
+		// members
+		STATUS      status{ STATUS::kNone };
+		FormID      expected{ 0 };
+		const Rule* rule{ nullptr };
+	};
+
+	// [Forms] rule keyed by a keyword of the base or the base's record type
+	struct WildcardRule
+	{
+		enum class TYPE
+		{
+			kKeyword,
+			kFormType
+		};
+
+		// members
+		TYPE          type{ TYPE::kKeyword };
+		std::uint32_t id{ 0 };  // keyword formID or record signature
+		Rule          rule{};
+	};
+
+	class RuleSet
+	{
+	public:
+		// a_paths : _SWAP.ini files or folders containing them, folders are read in sorted order like the plugin
+		// a_index has to outlive the rule set, wildcard rules read record types from it
+		static RuleSet Load(const PluginIndexer::Index& a_index, const std::vector<std::filesystem::path>& a_paths);
+
+		[[nodiscard]] Result Evaluate(const BOSTrace::Record& a_record) const;
+
+		[[nodiscard]] std::size_t size() const { return ruleCount; }
+
+	private:
+		void LoadINI(const PluginIndexer::Index& a_index, const std::filesystem::path& a_path);
+
+		// members
+		const PluginIndexer::Index*                               index{ nullptr };
+		std::unordered_map<FormID, std::vector<Rule>>             swapRefs{};
+		std::unordered_map<FormID, ConditionalList>               swapFormsConditional{};
+		std::unordered_map<FormID, std::vector<Rule>>             swapForms{};
+		std::vector<WildcardRule>                                 wildcards{};  // load order
+		std::size_t                                               ruleCount{ 0 };
+	};
+
+	// returns std::nullopt if the file is missing or has the wrong header, stops at the first truncated record
+	std::optional<std::vector<BOSTrace::Record>> ReadTrace(const std::filesystem::path& a_path);
+}
@@ -0,0 +1,451 @@
+#include "TraceReplay.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <ranges>
+
+namespace TraceReplay
+{
+	namespace
+	{
+		std::vector<std::string_view> split(std::string_view a_str, char a_delimiter)
+		{
+			std::vector<std::string_view> result;
+			for (std::size_t pos = 0;;) {
+				const auto next = a_str.find(a_delimiter, pos);
+				result.push_back(a_str.substr(pos, next - pos));
+				if (next == std::string_view::npos) {
+					break;
+				}
+				pos = next + 1;
+			}
+			return result;
+		}
+
+		// commas inside parentheses belong to spatial filters
+		std::vector<std::string_view> split_conditions(std::string_view a_str)
+		{
+			std::vector<std::string_view> result;
+			std::size_t                   start = 0;
+			std::int32_t                  depth = 0;
+			for (std::size_t i = 0; i < a_str.size(); ++i) {
+				if (a_str[i] == '(') {
+					depth++;
+				} else if (a_str[i] == ')') {
+					depth--;
+				} else if (a_str[i] == ',' && depth == 0) {
+					result.push_back(a_str.substr(start, i - start));
+					start = i + 1;
+				}
+			}
+			result.push_back(a_str.substr(start));
+			return result;
+		}
+
+		std::string_view trim(std::string_view a_str)
+		{
+			const auto first = a_str.find_first_not_of(" \t\r\n");
+			if (first == std::string_view::npos) {
+				return {};
+			}
+			return a_str.substr(first, a_str.find_last_not_of(" \t\r\n") - first + 1);
+		}
+
+		float to_float(std::string_view a_str)
+		{
+			try {
+				return std::stof(std::string(trim(a_str)));
+			} catch (...) {
+				return 0.0f;
+			}
+		}
+
+		bool contains(const std::vector<FormID>& a_list, FormID a_formID)
+		{
+			return std::ranges::find(a_list, a_formID) != a_list.end();
+		}
+
+		// mirrors SpatialIndex::Parse
+		std::optional<Filter> parse_spatial(const PluginIndexer::Index& a_index, std::string_view a_str)
+		{
+			const auto open = a_str.find('(');
+			const auto close = a_str.rfind(')');
+			if (open == std::string_view::npos || close == std::string_view::npos || close < open) {
+				return std::nullopt;
+			}
+
+			const auto args = split(a_str.substr(open + 1, close - open - 1), ',');
+
+			Filter filter;
+			if (const auto worldspace = a_index.Resolve(trim(args[0]))) {
+				filter.formID = *worldspace;
+			} else {
+				return std::nullopt;
+			}
+
+			std::vector<float> values;
+			for (auto it = args.begin() + 1; it != args.end(); ++it) {
+				values.push_back(to_float(*it));
+			}
+
+			if (a_str.starts_with("radius(") && (values.size() == 3 || values.size() == 4)) {
+				filter.type = values.size() == 3 ? Filter::TYPE::kRadius2D : Filter::TYPE::kRadius3D;
+				filter.center = { values[0], values[1], values.size() == 4 ? values[2] : 0.0f };
+				filter.radiusSquared = values.back() * values.back();
+			} else if (a_str.starts_with("box(") && values.size() == 6) {
+				filter.type = Filter::TYPE::kBox;
+				filter.min = { std::min(values[0], values[3]), std::min(values[1], values[4]), std::min(values[2], values[5]) };
+				filter.max = { std::max(values[0], values[3]), std::max(values[1], values[4]), std::max(values[2], values[5]) };
+			} else if (a_str.starts_with("cells(") && values.size() == 4) {
+				constexpr float cellSize = 4096.0f;
+				filter.type = Filter::TYPE::kBox;
+				filter.min = { std::min(values[0], values[2]) * cellSize, std::min(values[1], values[3]) * cellSize, std::numeric_limits<float>::lowest() };
+				filter.max = { (std::max(values[0], values[2]) + 1) * cellSize, (std::max(values[1], values[3]) + 1) * cellSize, std::numeric_limits<float>::max() };
+			} else {
+				return std::nullopt;
+			}
+
+			return filter;
+		}
+
+		// bound object types WildcardIndex accepts in type(...)
+		constexpr std::array<std::string_view, 22> wildcardTypes{
+			"ACTI", "ALCH", "AMMO", "ARMO", "BOOK", "CONT", "DOOR", "FLOR", "FURN", "HAZD", "IDLM",
+			"KEYM", "LIGH", "MISC", "MSTT", "NOTE", "PROJ", "SCOL", "STAT", "TACT", "TERM", "WEAP"
+		};
+
+		// mirrors WildcardIndex::Add, "keyword(EditorID)" or "type(STAT)"
+		std::optional<WildcardRule> parse_wildcard(const PluginIndexer::Index& a_index, std::string_view a_key)
+		{
+			const bool isKeyword = a_key.starts_with("keyword(");
+			if (!isKeyword && !a_key.starts_with("type(")) {
+				return std::nullopt;
+			}
+			const auto open = a_key.find('(');
+			const auto close = a_key.find(')', open);
+			if (close == std::string_view::npos) {
+				return std::nullopt;
+			}
+			const auto arg = trim(a_key.substr(open + 1, close - open - 1));
+
+			WildcardRule wildcard;
+			if (isKeyword) {
+				const auto keywordID = a_index.Resolve(arg);
+				if (!keywordID || a_index.GetFormType(*keywordID) != PluginIndexer::to_signature("KYWD")) {
+					return std::nullopt;
+				}
+				wildcard.type = WildcardRule::TYPE::kKeyword;
+				wildcard.id = *keywordID;
+			} else {
+				if (std::ranges::none_of(wildcardTypes, [&](std::string_view a_type) { return PluginIndexer::to_signature(a_type) == PluginIndexer::to_signature(arg); })) {
+					return std::nullopt;
+				}
+				wildcard.type = WildcardRule::TYPE::kFormType;
+				wildcard.id = PluginIndexer::to_signature(arg);
+			}
+			return wildcard;
+		}
+
+		// "chance(50)", "chanceR(50)", "chanceL(50)"
+		bool has_chance(std::string_view a_str)
+		{
+			if (!a_str.contains("chance")) {
+				return false;
+			}
+			const auto open = a_str.find('(');
+			const auto close = a_str.find(')');
+			if (open == std::string_view::npos || close == std::string_view::npos || close < open) {
+				return false;
+			}
+			return to_float(a_str.substr(open + 1, close - open - 1)) < 100.0f;
+		}
+	}
+
+	bool Filter::IsValid(const BOSTrace::Record& a_record) const
+	{
+		const auto& pos = a_record.position;
+
+		switch (type) {
+		case TYPE::kForm:
+			return a_record.cell == formID ||
+			       contains(a_record.locations, formID) ||
+			       std::ranges::binary_search(a_record.regions, formID) ||
+			       contains(a_record.locationKeywords, formID) ||
+			       contains(a_record.refKeywords, formID);
+		case TYPE::kRadius2D:
+			{
+				const auto dx = pos[0] - center[0];
+				const auto dy = pos[1] - center[1];
+				return a_record.worldspace == formID && dx * dx + dy * dy <= radiusSquared;
+			}
+		case TYPE::kRadius3D:
+			{
+				const auto dx = pos[0] - center[0];
+				const auto dy = pos[1] - center[1];
+				const auto dz = pos[2] - center[2];
+				return a_record.worldspace == formID && dx * dx + dy * dy + dz * dz <= radiusSquared;
+			}
+		case TYPE::kBox:
+			return a_record.worldspace == formID &&
+			       pos[0] >= min[0] && pos[0] <= max[0] &&
+			       pos[1] >= min[1] && pos[1] <= max[1] &&
+			       pos[2] >= min[2] && pos[2] <= max[2];
+		default:
+			return false;
+		}
+	}
+
+	RuleSet RuleSet::Load(const PluginIndexer::Index& a_index, const std::vector<std::filesystem::path>& a_paths)
+	{
+		RuleSet ruleSet;
+		ruleSet.index = std::addressof(a_index);
+
+		for (const auto& path : a_paths) {
+			if (std::filesystem::is_directory(path)) {
+				std::vector<std::filesystem::path> configs;
+				for (const auto& entry : std::filesystem::directory_iterator(path)) {
+					const auto name = PluginIndexer::to_lower(entry.path().filename().string());
+					if (entry.is_regular_file() && name.ends_with(".ini") && name.contains("_swap")) {
+						configs.push_back(entry.path());
+					}
+				}
+				std::ranges::sort(configs);
+				for (const auto& config : configs) {
+					ruleSet.LoadINI(a_index, config);
+				}
+			} else {
+				ruleSet.LoadINI(a_index, path);
+			}
+		}
+
+		return ruleSet;
+	}
+
+	void RuleSet::LoadINI(const PluginIndexer::Index& a_index, const std::filesystem::path& a_path)
+	{
+		std::ifstream file(a_path);
+		if (!file) {
+			std::cerr << a_path.string() << ": couldn't read INI\n";
+			return;
+		}
+
+		enum class SECTION
+		{
+			kNone,
+			kForms,
+			kFormsConditional,
+			kReferences
+		};
+
+		auto                sectionType = SECTION::kNone;
+		std::vector<Filter> notFilters;
+		std::vector<Filter> matchFilters;
+
+		for (std::string line; std::getline(file, line);) {
+			auto entry = trim(line);
+			if (entry.empty() || entry.starts_with(';') || entry.starts_with('#')) {
+				continue;
+			}
+
+			if (entry.starts_with('[')) {
+				const auto section = trim(entry.substr(1, entry.find(']') - 1));
+				const auto splitSection = split(section, '|');
+
+				notFilters.clear();
+				matchFilters.clear();
+
+				if (splitSection[0] == "Forms" && splitSection.size() > 1) {
+					sectionType = SECTION::kFormsConditional;
+					for (auto condition : split_conditions(splitSection[1])) {
+						condition = trim(condition);
+						const bool negate = condition.starts_with('-');
+						if (negate) {
+							condition.remove_prefix(1);
+						}
+
+						Filter filter;
+						if (condition.starts_with("radius(") || condition.starts_with("box(") || condition.starts_with("cells(")) {
+							if (const auto spatial = parse_spatial(a_index, condition)) {
+								filter = *spatial;
+							} else {
+								filter.type = Filter::TYPE::kUnresolved;  // the plugin keeps it as an editorID no form has
+							}
+						} else if (const auto formID = a_index.ResolveFilter(condition)) {
+							filter.formID = *formID;  // editorIDs resolved through the index, raw formIDs as is
+						} else {
+							filter.type = Filter::TYPE::kUnresolved;  // no plugin has this editorID, nor does any cell or keyword
+						}
+						(negate ? notFilters : matchFilters).push_back(filter);
+					}
+				} else if (splitSection[0] == "Forms") {
+					sectionType = SECTION::kForms;
+				} else if (splitSection[0] == "References") {
+					sectionType = SECTION::kReferences;
+				} else {
+					sectionType = SECTION::kNone;  // properties don't change the swapped base
+				}
+				continue;
+			}
+
+			if (sectionType == SECTION::kNone) {
+				continue;
+			}
+
+			entry = trim(entry.substr(0, entry.find('=')));
+
+			const auto formPair = split(entry, '|');
+			if (formPair.size() < 2) {
+				continue;
+			}
+
+			std::optional<WildcardRule> wildcard;
+			std::optional<FormID>       baseID;
+			if (sectionType == SECTION::kForms && (formPair[0].starts_with("keyword(") || formPair[0].starts_with("type("))) {
+				wildcard = parse_wildcard(a_index, formPair[0]);
+				if (!wildcard) {
+					continue;
+				}
+			} else if (baseID = a_index.Resolve(trim(formPair[0])); !baseID) {
+				continue;
+			}
+
+			Rule rule;
+			rule.record = std::string(entry);
+			rule.path = a_path.filename().string();
+			rule.chance = formPair.size() > 3 && has_chance(formPair[3]);
+			for (const auto swap : split(formPair[1], ',')) {
+				if (const auto swapID = a_index.Resolve(trim(swap))) {
+					rule.swaps.push_back(*swapID);
+				}
+			}
+			if (rule.swaps.empty()) {
+				continue;
+			}
+
+			if (wildcard) {
+				wildcard->rule = std::move(rule);
+				wildcards.push_back(std::move(*wildcard));
+				ruleCount++;
+				continue;
+			}
+
+			switch (sectionType) {
+			case SECTION::kForms:
+				swapForms[*baseID].push_back(std::move(rule));
+				break;
+			case SECTION::kFormsConditional:
+				{
+					auto& list = swapFormsConditional[*baseID];
+					list.rules.push_back(std::move(rule));
+					list.compiled.Add(notFilters, matchFilters);
+				}
+				break;
+			case SECTION::kReferences:
+				swapRefs[*baseID].push_back(std::move(rule));
+				break;
+			default:
+				break;
+			}
+			ruleCount++;
+		}
+	}
+
+	Result RuleSet::Evaluate(const BOSTrace::Record& a_record) const
+	{
+		if (a_record.flags & BOSTrace::Record::kRestored) {
+			return { Result::STATUS::kRestored, a_record.result, nullptr };
+		}
+
+		// form swaps : base first, material swap if the base has no entry
+		const auto find = [&]<class T>(const std::unordered_map<FormID, T>& a_map) -> const T* {
+			auto it = a_map.find(a_record.base);
+			if (it == a_map.end() && a_record.materialSwap != 0) {
+				it = a_map.find(a_record.materialSwap);
+			}
+			return it != a_map.end() ? &it->second : nullptr;
+		};
+
+		const Rule* winner = nullptr;
+
+		if (!(a_record.flags & BOSTrace::Record::kCreated)) {
+			if (const auto it = swapRefs.find(a_record.ref); it != swapRefs.end() && !it->second.empty()) {
+				winner = &it->second.back();
+			}
+		}
+
+		// the winning conditional entry ends the conditional stage even if its chance fails
+		const Rule* conditionalWinner = nullptr;
+		if (const auto list = find(swapFormsConditional)) {
+			const auto index = list->compiled.FindLast(
+				[&](std::uint32_t, const Filter& a_filter) { return a_filter.IsValid(a_record); },
+				[](std::size_t, auto&& a_evaluate) { return a_evaluate(); });
+			if (index) {
+				conditionalWinner = &list->rules[*index];
+			}
+		}
+
+		const Rule* formWinner = nullptr;
+		if (const auto rules = find(swapForms); rules && !rules->empty()) {
+			formWinner = &rules->back();
+		}
+
+		// consulted after exact form swaps, keyword and type rules alike
+		const Rule* wildcardWinner = nullptr;
+		if (!wildcards.empty()) {
+			const auto baseType = index->GetFormType(a_record.base);
+			const auto it = std::ranges::find_if(wildcards | std::views::reverse, [&](const WildcardRule& a_wildcard) {
+				return a_wildcard.type == WildcardRule::TYPE::kKeyword ? contains(a_record.refKeywords, a_wildcard.id) : a_wildcard.id == baseType;
+			});
+			if (it != wildcards.rend()) {
+				wildcardWinner = &it->rule;
+			}
+		}
+
+		for (const auto rule : { winner, conditionalWinner, formWinner, wildcardWinner }) {
+			if (!rule) {
+				continue;
+			}
+			if (rule->chance || rule->swaps.size() > 1) {
+				return { Result::STATUS::kRandom, 0, rule };
+			}
+			const auto expected = rule->swaps.front() == a_record.base ? 0 : rule->swaps.front();
+			return { expected == a_record.result ? Result::STATUS::kMatch : Result::STATUS::kMismatch, expected, rule };
+		}
+
+		return { a_record.result == 0 ? Result::STATUS::kNone : Result::STATUS::kMismatch, 0, nullptr };
+	}
+
+	std::optional<std::vector<BOSTrace::Record>> ReadTrace(const std::filesystem::path& a_path)
+	{
+		std::ifstream file(a_path, std::ios::binary);
+		if (!file) {
+			return std::nullopt;
+		}
+
+		const std::vector<std::uint8_t> buffer{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+
+		BOSTrace::FileHeader header;
+		if (buffer.size() < sizeof(header)) {
+			return std::nullopt;
+		}
+		std::memcpy(&header, buffer.data(), sizeof(header));
+		if (header.magic != BOSTrace::MAGIC || header.version != BOSTrace::VERSION) {
+			return std::nullopt;
+		}
+
+		std::vector<BOSTrace::Record> records;
+		for (std::size_t pos = sizeof(header); pos < buffer.size();) {
+			BOSTrace::Record record;
+			if (!BOSTrace::ReadRecord(buffer, pos, record)) {
+				std::cerr << a_path.string() << ": truncated record at offset " << pos << "\n";
+				break;
+			}
+			records.push_back(std::move(record));
+		}
+
+		return records;
+	}
+}
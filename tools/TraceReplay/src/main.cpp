@@ -0,0 +1,134 @@
+#include "TraceReplay.h"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <utility>
+
+namespace
+{
+	constexpr std::array statusNames{ "none", "match", "mismatch", "random", "restored" };
+
+	std::string to_csv(const BOSTrace::Record& a_record, const TraceReplay::Result& a_result)
+	{
+		std::ostringstream line;
+		line << std::hex << std::uppercase << std::setfill('0');
+		for (const auto formID : { a_record.ref, a_record.base, a_record.result, a_result.expected }) {
+			line << std::setw(8) << formID << ",";
+		}
+		line << statusNames[std::to_underlying(a_result.status)] << ",";
+		if (a_result.rule) {
+			line << "\"" << a_result.rule->record << "\"," << a_result.rule->path;
+		} else {
+			line << ",";
+		}
+		return line.str();
+	}
+
+	// compares everything but the recorded result, so a baseline can come from a different trace of the same refs
+	std::size_t diff(const std::vector<std::string>& a_lines, const std::filesystem::path& a_baseline)
+	{
+		std::ifstream file(a_baseline);
+		if (!file) {
+			std::cerr << a_baseline.string() << ": couldn't read baseline\n";
+			return 1;
+		}
+
+		const auto strip_recorded = [](std::string_view a_line) {
+			const auto first = a_line.find(',', a_line.find(',') + 1);
+			const auto second = a_line.find(',', first + 1);
+			return std::string(a_line.substr(0, first)).append(a_line.substr(second));
+		};
+
+		std::size_t differences = 0;
+		std::size_t lineNum = 0;
+		std::string line;
+		std::getline(file, line);  // header
+		for (; std::getline(file, line) && lineNum < a_lines.size(); ++lineNum) {
+			if (strip_recorded(line) != strip_recorded(a_lines[lineNum])) {
+				if (differences++ < 20) {
+					std::cout << "- " << line << "\n+ " << a_lines[lineNum] << "\n";
+				}
+			}
+		}
+		if (lineNum != a_lines.size() || std::getline(file, line)) {
+			std::cout << "baseline has a different number of records\n";
+			differences++;
+		}
+
+		std::cout << differences << " records differ from " << a_baseline.string() << "\n";
+		return differences;
+	}
+}
+
+int main(int a_argc, char* a_argv[])
+{
+	if (a_argc < 5) {
+		std::cerr << "usage: " << a_argv[0] << " <Data folder> <plugins.txt> <trace> [--out results.csv] [--diff baseline.csv] <_SWAP.ini or folder ...>\n";
+		return 2;
+	}
+
+	const std::filesystem::path dataDir(a_argv[1]);
+	const std::filesystem::path tracePath(a_argv[3]);
+
+	std::filesystem::path              outPath;
+	std::filesystem::path              baselinePath;
+	std::vector<std::filesystem::path> configs;
+	for (int i = 4; i < a_argc; ++i) {
+		const std::string_view arg(a_argv[i]);
+		if (arg == "--out" && i + 1 < a_argc) {
+			outPath = a_argv[++i];
+		} else if (arg == "--diff" && i + 1 < a_argc) {
+			baselinePath = a_argv[++i];
+		} else {
+			configs.emplace_back(arg);
+		}
+	}
+
+	const auto records = TraceReplay::ReadTrace(tracePath);
+	if (!records) {
+		std::cerr << tracePath.string() << ": not a swap trace, or written by a different version\n";
+		return 2;
+	}
+
+	const auto loadOrder = PluginIndexer::ReadLoadOrder(a_argv[2], dataDir);
+	const auto index = PluginIndexer::Index::Build(dataDir, loadOrder);
+	const auto ruleSet = TraceReplay::RuleSet::Load(index, configs);
+
+	std::cout << records->size() << " trace records, " << ruleSet.size() << " swap rules\n";
+
+	std::array<std::size_t, statusNames.size()> counts{};
+	std::vector<std::string>                    lines;
+	lines.reserve(records->size());
+
+	const auto start = std::chrono::steady_clock::now();
+	for (const auto& record : *records) {
+		const auto result = ruleSet.Evaluate(record);
+		counts[std::to_underlying(result.status)]++;
+		lines.push_back(to_csv(record, result));
+	}
+	const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+	std::cout << "replayed in " << elapsed.count() / 1000000.0 << " ms ("
+			  << (records->empty() ? 0 : elapsed.count() / records->size()) << " ns per record)\n";
+	for (std::size_t i = 0; i < counts.size(); ++i) {
+		std::cout << "\t" << statusNames[i] << " : " << counts[i] << "\n";
+	}
+
+	if (!outPath.empty()) {
+		std::ofstream out(outPath);
+		out << "ref,base,recorded,expected,status,rule,path\n";
+		for (const auto& line : lines) {
+			out << line << "\n";
+		}
+	}
+
+	std::size_t failures = counts[std::to_underlying(TraceReplay::Result::STATUS::kMismatch)];
+	if (!baselinePath.empty()) {
+		failures += diff(lines, baselinePath);
+	}
+
+	return failures == 0 ? 0 : 1;
+}